@@ -4,6 +4,7 @@
 #include "InventoryComponent.h"
 #include "Item.h"
 #include "ItemDataAsset.h"
+#include "SaveSubsystem.h"
 
 DEFINE_LOG_CATEGORY(LogInventory);
 
@@ -156,6 +157,10 @@ bool UInventoryComponent::AddItem(UItem* Item, int32 Count, int32& FailedCount)
 	}
 
 	FailedCount = RemainingItem;
+
+	if (RemainingItem != Count)
+		USaveSubsystem::MarkSaveDirty(this);
+
 	return RemainingItem == Count;
 }
 
@@ -190,6 +195,9 @@ void UInventoryComponent::DiscardItemByClass(TSubclassOf<UItem> ItemClass, int32
 	}
 
 	FailedCount = ItemRemaining;
+
+	if (ItemRemaining != Count)
+		USaveSubsystem::MarkSaveDirty(this);
 }
 
 void UInventoryComponent::DiscardItemByIndex(int32 Index, int32 Count)
@@ -197,6 +205,7 @@ void UInventoryComponent::DiscardItemByIndex(int32 Index, int32 Count)
 	checkf(Index >= 0 && Index <=Items.Num(), TEXT("Index Out Of Bound On Discard Item"));
 
 	Items[Index].RemoveItem(Count);
+	USaveSubsystem::MarkSaveDirty(this);
 }
 
 bool UInventoryComponent::UseItem(AActor* User, bool DropItem, int32 Index, int32 Count, int32& FailedUsed)
@@ -212,7 +221,10 @@ bool UInventoryComponent::UseItem(AActor* User, bool DropItem, int32 Index, int3
 	FailedUsed = UsableItemCount - Count;
 
 	if (DropItem)
+	{
 		Items[Index].RemoveItem(UsableItemCount);
+		USaveSubsystem::MarkSaveDirty(this);
+	}
 
 	return false;
 }
@@ -242,6 +254,10 @@ bool UInventoryComponent::UseItemByClass(AActor* User, bool DropItem, TSubclassO
 	}	
 
 	FailedUsed = ItemRemaining;
+
+	if (DropItem && ItemRemaining < Count)
+		USaveSubsystem::MarkSaveDirty(this);
+
 	return ItemRemaining < Count;
 }
 
@@ -4,6 +4,8 @@
 #include "QuestSystem.h"
 #include "Quest.h"
 #include "SaveDataType.h"
+#include "SaveSubsystem.h"
+#include "SaveNameTableArchive.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/ObjectAndNameAsStringProxyArchive.h"
 
@@ -18,6 +20,8 @@ void UQuestSystem::StartQuest(UQuest* Quest)
 	CurrentQuest = Quest;
 	CurrentQuestClass = CurrentQuest->GetClass();
 
+	USaveSubsystem::MarkSaveDirty(this);
+
 	OnStartQuest.Broadcast(CurrentQuest);
 }
 
@@ -38,6 +42,7 @@ void UQuestSystem::SendQuestSignal(UObject* Sender, FName SignalName)
 		return;
 
 	CurrentQuest->ReceiveQuestSignal(Sender, SignalName);
+	USaveSubsystem::MarkSaveDirty(this);
 }
 
 void UQuestSystem::OnFinishedQuest()
@@ -50,6 +55,8 @@ void UQuestSystem::OnFinishedQuest()
 
 	CurrentQuest = nullptr;
 	CurrentQuestClass = nullptr;
+
+	USaveSubsystem::MarkSaveDirty(this);
 }
 
 void UQuestSystem::ForceEndQuest()
@@ -68,6 +75,13 @@ bool UQuestSystem::IsQuestFinished(TSubclassOf<UQuest> QuestClass)
 TArray<uint8> UQuestSystem::SaveData()
 {
 	TArray<uint8> Data;
+	USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this);
+
+	if (SaveSubsystem != nullptr)
+	{
+		FSaveNameTableArchive::SaveObject(this, Data, SaveSubsystem->GetNameTable());
+		return Data;
+	}
 
 	FMemoryWriter Writer(Data);
 	FObjectAndNameAsStringProxyArchive Ar(Writer, true);
@@ -80,11 +94,11 @@ TArray<uint8> UQuestSystem::SaveData()
 
 void UQuestSystem::LoadData(TArray<uint8> Data)
 {
-	FMemoryReader Reader(Data);
-	FObjectAndNameAsStringProxyArchive Ar(Reader, true);
-	Ar.ArIsSaveGame = true;
+	USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this);
 
-	Serialize(Ar);
+	//Untagged data is read through the string proxy archive, so an empty table is enough without the subsystem
+	FSaveNameTable FallbackNameTable;
+	FSaveNameTableArchive::LoadObject(this, Data, SaveSubsystem != nullptr ? SaveSubsystem->GetNameTable() : FallbackNameTable);
 
 	if (CurrentQuestClass == nullptr)
 		return;
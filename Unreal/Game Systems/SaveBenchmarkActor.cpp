@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveBenchmarkActor.h"
+
+USaveBenchmarkComponent::USaveBenchmarkComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void USaveBenchmarkComponent::OnActorSave_Implementation()
+{
+}
+
+void USaveBenchmarkComponent::OnActorLoaded_Implementation()
+{
+}
+
+ASaveBenchmarkActor::ASaveBenchmarkActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+}
+
+void ASaveBenchmarkActor::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	for (int32 i = 0; i < ComponentCount; i++)
+	{
+		//Fixed names so records of respawned actors find their component again
+		const FName ComponentName(*FString::Printf(TEXT("BenchmarkComponent%d"), i));
+
+		if (FindObjectFast<USaveBenchmarkComponent>(this, ComponentName) != nullptr)
+			continue;
+
+		USaveBenchmarkComponent* Component = NewObject<USaveBenchmarkComponent>(this, ComponentName);
+		AddInstanceComponent(Component);
+		Component->RegisterComponent();
+	}
+}
+
+void ASaveBenchmarkActor::OnActorSave_Implementation()
+{
+	SaveCounter++;
+}
+
+void ASaveBenchmarkActor::OnActorLoaded_Implementation()
+{
+}
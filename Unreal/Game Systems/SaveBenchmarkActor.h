@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "SaveLoadActorInterface.h"
+#include "SaveSerializationInterface.h"
+#include "SaveBenchmarkActor.generated.h"
+
+/**
+ * Save component used by the save benchmark, stands in for inventory style components.
+ * Holds a raw payload and a list of item classes so both plain bytes and object references go through the name table.
+ */
+UCLASS(ClassGroup = (Custom), NotBlueprintable)
+class SHADOWOFTHEOTHERSIDE_API USaveBenchmarkComponent : public UActorComponent, public ISaveLoadActorInterface, public ISaveSerializationInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	USaveBenchmarkComponent();
+
+public:
+
+	UPROPERTY(SaveGame)
+		TArray<uint8> Payload;
+
+	UPROPERTY(SaveGame)
+		TArray<TSubclassOf<UObject>> ItemClasses;
+
+	UPROPERTY(SaveGame)
+		TArray<int32> ItemCounts;
+
+public:
+
+	virtual void OnActorSave_Implementation() override;
+	virtual void OnActorLoaded_Implementation() override;
+
+	virtual bool CanSerializeOffGameThread() const override { return true; }
+};
+
+/**
+ * Synthetic SaveObject actor for the save benchmark. Creates ComponentCount save components during construction,
+ * so respawned actors get the same components back the way Blueprint added components do.
+ * The benchmark sets ComponentCount on a deferred spawn, respawns read it back from their record before construction.
+ */
+UCLASS(NotBlueprintable)
+class SHADOWOFTHEOTHERSIDE_API ASaveBenchmarkActor : public AActor, public ISaveLoadActorInterface, public ISaveSerializationInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	ASaveBenchmarkActor();
+
+public:
+
+	UPROPERTY(SaveGame)
+		int32 ComponentCount = 0;
+
+	UPROPERTY(SaveGame)
+		TArray<uint8> Payload;
+
+	UPROPERTY(SaveGame)
+		int32 SaveCounter = 0;
+
+public:
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	virtual void OnActorSave_Implementation() override;
+	virtual void OnActorLoaded_Implementation() override;
+
+	virtual bool CanSerializeOffGameThread() const override { return true; }
+};
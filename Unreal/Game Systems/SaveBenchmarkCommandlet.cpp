@@ -0,0 +1,710 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveBenchmarkCommandlet.h"
+#include "SaveBenchmarkActor.h"
+#include "SaveObjectRegistry.h"
+#include "SaveSlotFile.h"
+#include "SaveLevelView.h"
+#include "PhysicsDoor.h"
+#include "PlayableCharacter.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/SceneComponent.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/App.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Math/RandomStream.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveBenchmark, Log, All);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+LLM_DEFINE_TAG(SaveBenchmark);
+#endif
+
+namespace SaveBenchmark
+{
+	//Bytes the benchmark thread allocated during one operation and still holds, taken from the SaveBenchmark LLM tag.
+	//Only threads inside LLM_SCOPE_BYTAG(SaveBenchmark) are booked on it, other threads of the process are left out.
+	//-1 unless run with -llm. The operation is also bookmarked, -trace=memory,bookmark gives its allocation count in Memory Insights
+	struct FScopedOperationMemory
+	{
+		explicit FScopedOperationMemory(const TCHAR* Operation)
+		{
+			TRACE_BOOKMARK(TEXT("SaveBenchmark %s"), Operation);
+			StartBytes = GetTaggedBytes();
+		}
+
+		int64 Get() const
+		{
+			const int64 Bytes = GetTaggedBytes();
+			return Bytes >= 0 && StartBytes >= 0 ? Bytes - StartBytes : -1;
+		}
+
+		static int64 GetTaggedBytes()
+		{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+			if (FLowLevelMemTracker::IsEnabled())
+				return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, LLM_TAG_NAME(SaveBenchmark), ELLMTagSet::None);
+#endif
+			return -1;
+		}
+
+		int64 StartBytes = -1;
+	};
+
+	//Shaped like SaveGame property data: counters, grid aligned locations, flags and the odd id, so the codecs see what real records give them.
+	//bRandom fills incompressible bytes instead
+	static void FillPayload(TArray<uint8>& OutPayload, int32 Bytes, bool bRandom, FRandomStream& Random)
+	{
+		OutPayload.SetNumUninitialized(FMath::Max(Bytes, 0));
+
+		for (int32 Offset = 0; Offset < OutPayload.Num(); Offset += sizeof(int32))
+		{
+			int32 Field = 0;
+
+			switch (bRandom ? 7 : (Offset / sizeof(int32)) % 8)
+			{
+				case 0:
+				case 1:
+					Field = Random.RandRange(0, 99);
+					break;
+
+				case 2:
+				case 3:
+				case 4:
+				{
+					const float Location = Random.RandRange(-50, 50) * 100.0f;
+					FMemory::Memcpy(&Field, &Location, sizeof(Field));
+					break;
+				}
+
+				case 5:
+					Field = Random.RandRange(0, 1);
+					break;
+
+				default:
+					Field = (int32)Random.GetUnsignedInt();
+					break;
+			}
+
+			FMemory::Memcpy(OutPayload.GetData() + Offset, &Field, FMath::Min<int32>(sizeof(Field), OutPayload.Num() - Offset));
+		}
+	}
+
+	static void DeletePool(const FString& PoolPath)
+	{
+		IFileManager::Get().Delete(*PoolPath, false, true, true);
+		IFileManager::Get().Delete(*(PoolPath + TEXT(".tmp")), false, true, true);
+	}
+}
+
+USaveBenchmarkCommandlet::USaveBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 USaveBenchmarkCommandlet::Main(const FString& Params)
+{
+	FSaveBenchmarkConfig Config;
+
+	FParse::Value(*Params, TEXT("Actors="), Config.Actors);
+	FParse::Value(*Params, TEXT("Doors="), Config.Doors);
+	FParse::Value(*Params, TEXT("Components="), Config.Components);
+	FParse::Value(*Params, TEXT("BlobBytes="), Config.BlobBytes);
+	FParse::Value(*Params, TEXT("Items="), Config.Items);
+	FParse::Value(*Params, TEXT("Iterations="), Config.Iterations);
+	FParse::Value(*Params, TEXT("PlayerClass="), Config.PlayerClassPath);
+
+	FString CodecName;
+
+	if (FParse::Value(*Params, TEXT("Codec="), CodecName))
+	{
+		const int64 CodecValue = StaticEnum<ESaveChunkCodec>()->GetValueByNameString(CodecName);
+
+		if (CodecValue == INDEX_NONE)
+			UE_LOG(LogSaveBenchmark, Warning, TEXT("Unknown codec %s, using %s"), *CodecName, *StaticEnum<ESaveChunkCodec>()->GetNameStringByValue((int64)Config.Codec));
+		else
+			Config.Codec = (ESaveChunkCodec)CodecValue;
+	}
+
+	//Report what is actually written, a codec missing from this build falls back to Zlib
+	Config.Codec = FSaveSlotFile::GetAvailableCodec(Config.Codec);
+	Config.bParallelCompression = !FParse::Param(*Params, TEXT("SerialCompress"));
+	Config.bPoolBlobs = FParse::Param(*Params, TEXT("PoolBlobs"));
+	Config.bRandomPayload = FParse::Param(*Params, TEXT("RandomPayload"));
+
+	if (!FParse::Value(*Params, TEXT("Build="), Config.Build))
+		Config.Build = FApp::GetBuildVersion();
+
+	if (!FParse::Value(*Params, TEXT("Out="), Config.OutputDir))
+		Config.OutputDir = FPaths::ProjectSavedDir() / TEXT("Benchmarks");
+
+	//Started empty every time, a pool left by an earlier benchmark would already hold every blob
+	Config.PoolPath = Config.OutputDir / TEXT("SaveBenchmark.pool");
+	SaveBenchmark::DeletePool(Config.PoolPath);
+
+	if (FParse::Param(*Params, TEXT("Verify")))
+	{
+		const bool bPassed = RunChecks(Config);
+		SaveBenchmark::DeletePool(Config.PoolPath);
+
+		return bPassed ? 0 : 1;
+	}
+
+	TArray<FSaveBenchmarkResult> Results;
+
+	for (int32 Run = 0; Run < FMath::Max(Config.Iterations, 1); Run++)
+	{
+		RunIteration(Config, Run, Results);
+	}
+
+	SaveBenchmark::DeletePool(Config.PoolPath);
+
+	return WriteResults(Config, Results) ? 0 : 1;
+}
+
+void USaveBenchmarkCommandlet::RunIteration(const FSaveBenchmarkConfig& Config, int32 Run, TArray<FSaveBenchmarkResult>& OutResults)
+{
+	const FString SlotName = FString::Printf(TEXT("SaveBenchmark_%d"), Run);
+	IFileManager::Get().Delete(*FSaveSlotFile::GetSlotPath(SlotName), false, true, true);
+
+	//Save, then load back into the same world so every record is matched to a live actor
+	UGameInstance* GameInstance = CreateBenchmarkWorld(Config);
+	UWorld* World = GameInstance->GetWorld();
+	USaveSubsystem* SaveSubsystem = GameInstance->GetSubsystem<USaveSubsystem>();
+
+	PopulateWorld(World, Config, Run);
+
+	SaveSubsystem->bIncrementalSave = false;
+	SaveSubsystem->bTimeSlicedRespawn = false;
+	SaveSubsystem->SaveCodec = Config.Codec;
+	SaveSubsystem->bParallelCompression = Config.bParallelCompression;
+	SaveSubsystem->bPoolSaveBlobs = Config.bPoolBlobs;
+
+	//Memory still in use after each operation, against what was in use before it
+	uint64 UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	double StartTime = FPlatformTime::Seconds();
+	int64 TrackedBytes = -1;
+
+	{
+		LLM_SCOPE_BYTAG(SaveBenchmark);
+		SaveBenchmark::FScopedOperationMemory OperationMemory(TEXT("Save"));
+
+		SaveSubsystem->SaveGame(World, SlotName);
+		SaveSubsystem->WaitForPendingSave();
+
+		TrackedBytes = OperationMemory.Get();
+	}
+
+	AddResult(TEXT("Save"), Run, FPlatformTime::Seconds() - StartTime, SaveSubsystem->GetLastSaveTimings(), TrackedBytes, UsedMemory, OutResults);
+
+	//Only the level chunk, decoded on the benchmark thread. Its allocation count in Memory Insights has to stay the same however many records it holds
+	{
+		FSaveSlotFile SlotFile;
+		FSaveBlobPool Pool(Config.PoolPath);
+		FSaveLevelView View;
+		FSavePhaseTimings DecodeTimings;
+
+		const bool bOpened = SlotFile.Open(SlotName);
+		Pool.Open();
+
+		UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+		StartTime = FPlatformTime::Seconds();
+
+		{
+			LLM_SCOPE_BYTAG(SaveBenchmark);
+			SaveBenchmark::FScopedOperationMemory OperationMemory(TEXT("LoadDecode"));
+
+			if (bOpened && !SlotFile.ReadLevelView(World->GetFName(), View, SaveSubsystem->GetNameTable(), &Pool))
+				UE_LOG(LogSaveBenchmark, Warning, TEXT("Run %d could not decode the level chunk of %s"), Run, *SlotName);
+
+			TrackedBytes = OperationMemory.Get();
+		}
+
+		DecodeTimings.ReadSeconds = FPlatformTime::Seconds() - StartTime;
+
+		AddResult(TEXT("LoadDecode"), Run, DecodeTimings.ReadSeconds, DecodeTimings, TrackedBytes, UsedMemory, OutResults);
+	}
+
+	UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	StartTime = FPlatformTime::Seconds();
+
+	{
+		LLM_SCOPE_BYTAG(SaveBenchmark);
+		SaveBenchmark::FScopedOperationMemory OperationMemory(TEXT("LoadMatch"));
+
+		SaveSubsystem->LoadGame(World, SlotName);
+
+		TrackedBytes = OperationMemory.Get();
+	}
+
+	AddResult(TEXT("LoadMatch"), Run, FPlatformTime::Seconds() - StartTime, SaveSubsystem->GetLastLoadTimings(), TrackedBytes, UsedMemory, OutResults);
+
+	//Same load with reading and decoding on a worker, WorkerMs shows how much of ReadMs left the game thread
+	UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	StartTime = FPlatformTime::Seconds();
+
+	{
+		LLM_SCOPE_BYTAG(SaveBenchmark);
+		SaveBenchmark::FScopedOperationMemory OperationMemory(TEXT("LoadMatchAsync"));
+
+		SaveSubsystem->LoadGameAsync(World, SlotName);
+		SaveSubsystem->WaitForPendingLoad();
+
+		TrackedBytes = OperationMemory.Get();
+	}
+
+	AddResult(TEXT("LoadMatchAsync"), Run, FPlatformTime::Seconds() - StartTime, SaveSubsystem->GetLastLoadTimings(), TrackedBytes, UsedMemory, OutResults);
+
+	DestroyBenchmarkWorld(GameInstance);
+
+	//Load into a world with only the player so every record is respawned
+	GameInstance = CreateBenchmarkWorld(Config);
+	World = GameInstance->GetWorld();
+	SaveSubsystem = GameInstance->GetSubsystem<USaveSubsystem>();
+
+	SaveSubsystem->bTimeSlicedRespawn = false;
+
+	UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	StartTime = FPlatformTime::Seconds();
+
+	{
+		LLM_SCOPE_BYTAG(SaveBenchmark);
+		SaveBenchmark::FScopedOperationMemory OperationMemory(TEXT("LoadSpawn"));
+
+		SaveSubsystem->LoadGame(World, SlotName);
+
+		TrackedBytes = OperationMemory.Get();
+	}
+
+	AddResult(TEXT("LoadSpawn"), Run, FPlatformTime::Seconds() - StartTime, SaveSubsystem->GetLastLoadTimings(), TrackedBytes, UsedMemory, OutResults);
+
+	DestroyBenchmarkWorld(GameInstance);
+
+	IFileManager::Get().Delete(*FSaveSlotFile::GetSlotPath(SlotName), false, true, true);
+}
+
+bool USaveBenchmarkCommandlet::RunChecks(const FSaveBenchmarkConfig& Config)
+{
+	int32 Failed = 0;
+
+	Failed += CheckNewGameSave(Config) ? 0 : 1;
+	Failed += CheckPlacedTransform() ? 0 : 1;
+	Failed += CheckLevelLoadPlacedTransform(Config) ? 0 : 1;
+
+	if (Failed > 0)
+		UE_LOG(LogSaveBenchmark, Error, TEXT("%d save checks failed"), Failed);
+	else
+		UE_LOG(LogSaveBenchmark, Display, TEXT("All save checks passed"));
+
+	return Failed == 0;
+}
+
+bool USaveBenchmarkCommandlet::CheckNewGameSave(const FSaveBenchmarkConfig& Config)
+{
+	const FString OldSlotName = TEXT("SaveCheck_Old");
+	const FString NewSlotName = TEXT("SaveCheck_New");
+	const FString MissingSlotName = TEXT("SaveCheck_Missing");
+
+	for (const FString& SlotName : { OldSlotName, NewSlotName, MissingSlotName })
+	{
+		IFileManager::Get().Delete(*FSaveSlotFile::GetSlotPath(SlotName), false, true, true);
+	}
+
+	UGameInstance* GameInstance = CreateBenchmarkWorld(Config);
+	UWorld* World = GameInstance->GetWorld();
+	USaveSubsystem* SaveSubsystem = GameInstance->GetSubsystem<USaveSubsystem>();
+
+	PopulateWorld(World, Config, 0);
+
+	//Incremental saves reuse the previous record of clean actors, a record left over from the old slot would be written again
+	SaveSubsystem->bIncrementalSave = true;
+	SaveSubsystem->bTimeSlicedRespawn = false;
+
+	SaveSubsystem->SaveGame(World, OldSlotName);
+	SaveSubsystem->WaitForPendingSave();
+	SaveSubsystem->LoadGame(World, OldSlotName);
+
+	SaveSubsystem->LoadGame(World, MissingSlotName);
+
+	//Every actor of the new game differs from its record in the old slot
+	TMap<FName, TArray<uint8>> Expected;
+
+	for (TActorIterator<ASaveBenchmarkActor> It(World); It; ++It)
+	{
+		It->Payload.Add((uint8)Expected.Num());
+		Expected.Add(It->GetFName(), It->Payload);
+	}
+
+	SaveSubsystem->SaveGame(World, NewSlotName);
+	SaveSubsystem->WaitForPendingSave();
+
+	for (TActorIterator<ASaveBenchmarkActor> It(World); It; ++It)
+	{
+		It->Payload.Reset();
+	}
+
+	SaveSubsystem->LoadGame(World, NewSlotName);
+
+	int32 Mismatches = 0;
+
+	for (TActorIterator<ASaveBenchmarkActor> It(World); It; ++It)
+	{
+		const TArray<uint8>* Payload = Expected.Find(It->GetFName());
+
+		if (Payload == nullptr || *Payload != It->Payload)
+			Mismatches++;
+	}
+
+	DestroyBenchmarkWorld(GameInstance);
+
+	for (const FString& SlotName : { OldSlotName, NewSlotName })
+	{
+		IFileManager::Get().Delete(*FSaveSlotFile::GetSlotPath(SlotName), false, true, true);
+	}
+
+	if (Mismatches > 0)
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("CheckNewGameSave: %d of %d actors did not load what the new game saved"), Mismatches, Expected.Num());
+		return false;
+	}
+
+	UE_LOG(LogSaveBenchmark, Display, TEXT("CheckNewGameSave passed, %d actors"), Expected.Num());
+	return true;
+}
+
+bool USaveBenchmarkCommandlet::CheckPlacedTransform()
+{
+	const FName ActorName = TEXT("PlacedDoor");
+	const FTransform PlacedTransform(FRotator(0.0f, 90.0f, 0.0f), FVector(120.0f, -40.0f, 10.0f), FVector(1.0f, 2.0f, 1.0f));
+
+	FSaveNameTable NameTable;
+
+	auto WriteLevel = [&](const FTransform& Transform, FSavePlacedTransforms* Placed)
+	{
+		FLevelSaveData LevelData;
+		FActorSaveData& Record = LevelData.LevelActorData.AddDefaulted_GetRef();
+		Record.ActorClass = APhysicsDoor::StaticClass();
+		Record.ActorName = ActorName;
+		Record.Transform = Transform;
+
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		FSaveNameTableArchive Ar(Writer, NameTable);
+
+		FSaveSlotFile::SerializeLevelChunk(Ar, LevelData, ESaveChunkEncoding::NameTableDelta, nullptr, Placed);
+		return Bytes;
+	};
+
+	auto ReadTransform = [&](const TArray<uint8>& Bytes, FSavePlacedTransforms* Placed)
+	{
+		FLevelSaveData LevelData;
+		FMemoryReader Reader(Bytes);
+		FSaveNameTableArchive Ar(Reader, NameTable);
+
+		FSaveSlotFile::SerializeLevelChunk(Ar, LevelData, ESaveChunkEncoding::NameTableDelta, nullptr, Placed);
+		return LevelData.LevelActorData.Num() == 1 ? LevelData.LevelActorData[0].Transform : FTransform(FVector(-1.0f));
+	};
+
+	FSavePlacedTransforms Placed;
+	Placed.Transforms.Add(ActorName, PlacedTransform);
+
+	//An identity transform only writes the flags, so an unmoved placed actor must come out at the same size
+	const TArray<uint8> Unmoved = WriteLevel(PlacedTransform, &Placed);
+	const TArray<uint8> Identity = WriteLevel(FTransform::Identity, nullptr);
+
+	if (Unmoved.Num() != Identity.Num())
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("CheckPlacedTransform: unmoved placed actor wrote %d bytes, %d expected"), Unmoved.Num(), Identity.Num());
+		return false;
+	}
+
+	if (!ReadTransform(Unmoved, &Placed).Equals(PlacedTransform, 0.0f))
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("CheckPlacedTransform: unmoved placed actor did not read back at its placed transform"));
+		return false;
+	}
+
+	//Only the location moved, rotation and scale still follow the level
+	FTransform Moved = PlacedTransform;
+	Moved.SetLocation(FVector(300.0f, 0.0f, 10.0f));
+
+	FSavePlacedTransforms Replaced;
+	Replaced.Transforms.Add(ActorName, FTransform(FRotator(0.0f, 180.0f, 0.0f), FVector::ZeroVector, FVector::OneVector));
+
+	FTransform Expected = Replaced.Transforms[ActorName];
+	Expected.SetLocation(Moved.GetLocation());
+
+	if (!ReadTransform(WriteLevel(Moved, &Placed), &Replaced).Equals(Expected, 0.0f))
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("CheckPlacedTransform: moved placed actor did not keep its location over the new placement"));
+		return false;
+	}
+
+	//Read without the level, the parts wait for it and are not taken from the placeholders
+	FSavePlacedTransforms Unloaded;
+	ReadTransform(Unmoved, &Unloaded);
+
+	if (Unloaded.UnresolvedParts.FindRef(ActorName) != SaveTransformParts::All || WriteLevel(FTransform::Identity, &Unloaded).Num() != Identity.Num())
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("CheckPlacedTransform: placed parts read without their level were lost"));
+		return false;
+	}
+
+	UE_LOG(LogSaveBenchmark, Display, TEXT("CheckPlacedTransform passed, %d bytes per unmoved placed actor"), Unmoved.Num());
+	return true;
+}
+
+bool USaveBenchmarkCommandlet::CheckLevelLoadPlacedTransform(const FSaveBenchmarkConfig& Config)
+{
+	const FString SlotName = TEXT("SaveCheck_LevelLoad");
+	const FName ActorName = TEXT("SaveCheck_PlacedDoor");
+	const FTransform SavedPlacement(FRotator(0.0f, 90.0f, 0.0f), FVector(120.0f, -40.0f, 10.0f), FVector(1.0f, 2.0f, 1.0f));
+	const FTransform NewPlacement(FRotator(0.0f, 180.0f, 0.0f), FVector(-300.0f, 80.0f, 0.0f), FVector::OneVector);
+
+	IFileManager::Get().Delete(*FSaveSlotFile::GetSlotPath(SlotName), false, true, true);
+
+	UGameInstance* GameInstance = CreateBenchmarkWorld(Config);
+	UWorld* World = GameInstance->GetWorld();
+	USaveSubsystem* SaveSubsystem = GameInstance->GetSubsystem<USaveSubsystem>();
+
+	//Registered the way a streamed in level registers, the door is saved unmoved so its record only holds placed parts
+	AddPlacedDoor(World, ActorName, SavedPlacement)->RegisterAllComponents();
+	World->GetSubsystem<USaveObjectRegistry>()->RegisterLevelActors(World->PersistentLevel);
+
+	SaveSubsystem->SaveGame(World, SlotName);
+	SaveSubsystem->WaitForPendingSave();
+
+	//The next world of the game instance, initialized only once the door is in its level, the way OpenLevel loads a map.
+	//The level has moved the door since the save, an unmoved door follows it
+	SaveSubsystem->LoadGameOnLevelLoad(SlotName);
+
+	UWorld* LevelLoadWorld = UWorld::CreateWorld(EWorldType::Game, false, World->GetFName(), nullptr, true, ERHIFeatureLevel::Num, nullptr, true);
+	LevelLoadWorld->SetGameInstance(GameInstance);
+
+	APhysicsDoor* Door = AddPlacedDoor(LevelLoadWorld, ActorName, NewPlacement);
+	LevelLoadWorld->InitWorld();
+
+	const FTransform LoadedTransform = Door->GetRootComponent()->GetRelativeTransform();
+	const FTransform* PlacedTransform = LevelLoadWorld->GetSubsystem<USaveObjectRegistry>()->FindPlacedTransform(Door);
+
+	const bool bLoadedAtPlacement = LoadedTransform.Equals(NewPlacement, KINDA_SMALL_NUMBER);
+	const bool bPlacementKept = PlacedTransform != nullptr && PlacedTransform->Equals(NewPlacement, KINDA_SMALL_NUMBER);
+
+	LevelLoadWorld->DestroyWorld(false);
+	LevelLoadWorld->RemoveFromRoot();
+
+	DestroyBenchmarkWorld(GameInstance);
+
+	IFileManager::Get().Delete(*FSaveSlotFile::GetSlotPath(SlotName), false, true, true);
+
+	if (!bLoadedAtPlacement)
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("CheckLevelLoadPlacedTransform: unmoved placed actor loaded at %s instead of %s"), *LoadedTransform.ToString(), *NewPlacement.ToString());
+		return false;
+	}
+
+	if (!bPlacementKept)
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("CheckLevelLoadPlacedTransform: placed transform was not registered before the load applied its record"));
+		return false;
+	}
+
+	UE_LOG(LogSaveBenchmark, Display, TEXT("CheckLevelLoadPlacedTransform passed"));
+	return true;
+}
+
+APhysicsDoor* USaveBenchmarkCommandlet::AddPlacedDoor(UWorld* World, FName ActorName, const FTransform& Transform)
+{
+	APhysicsDoor* Door = NewObject<APhysicsDoor>(World->PersistentLevel, ActorName);
+	Door->Tags.Add(USaveObjectRegistry::SaveObjectTag);
+
+	//Only the serialized relative transform, the world transform stays identity until the components register
+	USceneComponent* Root = Door->GetRootComponent();
+	Root->SetRelativeLocation_Direct(Transform.GetLocation());
+	Root->SetRelativeRotation_Direct(Transform.Rotator());
+	Root->SetRelativeScale3D_Direct(Transform.GetScale3D());
+
+	World->PersistentLevel->Actors.Add(Door);
+	return Door;
+}
+
+UGameInstance* USaveBenchmarkCommandlet::CreateBenchmarkWorld(const FSaveBenchmarkConfig& Config)
+{
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+
+	//Same world name every time, saved levels are keyed by it
+	GameInstance->InitializeStandalone(TEXT("SaveBenchmark"));
+
+	UWorld* World = GameInstance->GetWorld();
+	World->InitializeActorsForPlay(FURL());
+
+	GameInstance->GetSubsystem<USaveSubsystem>()->GetBlobPool().SetPath(Config.PoolPath);
+
+	UClass* PlayerClass = Config.PlayerClassPath.IsEmpty() ? APlayableCharacter::StaticClass()
+		: LoadClass<APlayableCharacter>(nullptr, *Config.PlayerClassPath);
+
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	APawn* PlayerPawn = PlayerClass != nullptr ? World->SpawnActor<APawn>(PlayerClass, FTransform::Identity) : nullptr;
+
+	if (PlayerController != nullptr && PlayerPawn != nullptr)
+		PlayerController->Possess(PlayerPawn);
+
+	return GameInstance;
+}
+
+void USaveBenchmarkCommandlet::DestroyBenchmarkWorld(UGameInstance* GameInstance)
+{
+	UWorld* World = GameInstance->GetWorld();
+
+	GameInstance->Shutdown();
+
+	World->DestroyWorld(false);
+	GEngine->DestroyWorldContext(World);
+
+	GameInstance->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void USaveBenchmarkCommandlet::PopulateWorld(UWorld* World, const FSaveBenchmarkConfig& Config, int32 Seed)
+{
+	FRandomStream Random(Seed);
+	USaveObjectRegistry* Registry = World->GetSubsystem<USaveObjectRegistry>();
+
+	//Classes referenced by the inventory style components, resolved through the name table as object paths
+	const TArray<TSubclassOf<UObject>> ItemClasses = { AActor::StaticClass(), APhysicsDoor::StaticClass(), ASaveBenchmarkActor::StaticClass(), USaveBenchmarkComponent::StaticClass() };
+
+	for (int32 i = 0; i < Config.Actors; i++)
+	{
+		const FTransform Transform(FVector((i % 100) * 200.0f, (i / 100) * 200.0f, 0.0f));
+		ASaveBenchmarkActor* Actor = World->SpawnActorDeferred<ASaveBenchmarkActor>(ASaveBenchmarkActor::StaticClass(), Transform);
+
+		Actor->Tags.Add(USaveObjectRegistry::SaveObjectTag);
+		Actor->ComponentCount = Config.Components;
+		SaveBenchmark::FillPayload(Actor->Payload, Config.BlobBytes, Config.bRandomPayload, Random);
+
+		Actor->FinishSpawning(Transform);
+
+		TArray<USaveBenchmarkComponent*> Components;
+		Actor->GetComponents(Components);
+
+		for (USaveBenchmarkComponent* Component : Components)
+		{
+			//A payload of its own, copies of the actor's would compress and pool far better than real components do
+			SaveBenchmark::FillPayload(Component->Payload, Config.BlobBytes, Config.bRandomPayload, Random);
+
+			for (int32 Item = 0; Item < Config.Items; Item++)
+			{
+				Component->ItemClasses.Add(ItemClasses[Random.RandRange(0, ItemClasses.Num() - 1)]);
+				Component->ItemCounts.Add(Random.RandRange(1, 99));
+			}
+		}
+
+		if (Registry != nullptr)
+		{
+			Registry->RegisterSaveObject(Actor);
+			Registry->RefreshSaveComponents(Actor);
+		}
+	}
+
+	for (int32 i = 0; i < Config.Doors; i++)
+	{
+		const FTransform Transform(FVector((i % 100) * 200.0f, (i / 100) * 200.0f, 1000.0f));
+		APhysicsDoor* Door = World->SpawnActorDeferred<APhysicsDoor>(APhysicsDoor::StaticClass(), Transform);
+
+		Door->Tags.Add(USaveObjectRegistry::SaveObjectTag);
+		Door->FinishSpawning(Transform);
+
+		if (Registry != nullptr)
+			Registry->RegisterSaveObject(Door);
+	}
+}
+
+void USaveBenchmarkCommandlet::AddResult(const FString& Operation, int32 Run, double WallSeconds, const FSavePhaseTimings& Timings, int64 TrackedBytes, uint64 UsedMemoryBefore, TArray<FSaveBenchmarkResult>& OutResults)
+{
+	FSaveBenchmarkResult& Result = OutResults.AddDefaulted_GetRef();
+	Result.Run = Run;
+	Result.Operation = Operation;
+	Result.WallSeconds = WallSeconds;
+	Result.Timings = Timings;
+	Result.UsedMemoryDelta = (int64)FPlatformMemory::GetStats().UsedPhysical - (int64)UsedMemoryBefore;
+	Result.TrackedBytes = TrackedBytes;
+
+	UE_LOG(LogSaveBenchmark, Display, TEXT("Run %d %s: %.3fms, %lld bytes written, %lld bytes held by the benchmark thread"), Run, *Operation, WallSeconds * 1000.0, Timings.BytesWritten, TrackedBytes);
+}
+
+void USaveBenchmarkCommandlet::GetCompressionStats(const FSavePhaseTimings& Timings, double& OutRatio, double& OutMBPerSecond, double& OutMBPerSecondPerCore)
+{
+	const double UncompressedMB = Timings.BytesUncompressed / (1024.0 * 1024.0);
+
+	//Only saves compress, loads report zeros
+	OutRatio = Timings.BytesWritten > 0 ? (double)Timings.BytesUncompressed / Timings.BytesWritten : 0.0;
+	OutMBPerSecond = Timings.CompressSeconds > 0.0 ? UncompressedMB / Timings.CompressSeconds : 0.0;
+	OutMBPerSecondPerCore = Timings.CompressWorkerSeconds > 0.0 ? UncompressedMB / Timings.CompressWorkerSeconds : 0.0;
+}
+
+bool USaveBenchmarkCommandlet::WriteResults(const FSaveBenchmarkConfig& Config, const TArray<FSaveBenchmarkResult>& Results)
+{
+	const FString CodecName = StaticEnum<ESaveChunkCodec>()->GetNameStringByValue((int64)Config.Codec);
+
+	FString Csv = TEXT("Build,Codec,Run,Operation,Actors,Doors,Components,BlobBytes,Items,WallMs,IterateMs,SerializeMs,WriteMs,ReadMs,WorkerMs,MatchMs,SpawnMs,CompressMs,BytesWritten,BytesUncompressed,CompressionRatio,CompressMBps,CompressMBpsPerCore,UsedMemoryDeltaMB,TrackedBytes,TrackedBytesPerRecord\n");
+	FString Json = TEXT("{\n\t\"build\": \"") + Config.Build + TEXT("\",\n\t\"codec\": \"") + CodecName
+		+ TEXT("\",\n\t\"parallelCompression\": ") + (Config.bParallelCompression ? TEXT("true") : TEXT("false"))
+		+ TEXT(",\n\t\"pooledBlobs\": ") + (Config.bPoolBlobs ? TEXT("true") : TEXT("false"))
+		+ TEXT(",\n\t\"randomPayload\": ") + (Config.bRandomPayload ? TEXT("true") : TEXT("false")) + TEXT(",\n\t\"results\": [\n");
+
+	for (int32 i = 0; i < Results.Num(); i++)
+	{
+		const FSaveBenchmarkResult& Result = Results[i];
+		const FSavePhaseTimings& Timings = Result.Timings;
+		const double UsedMemoryDeltaMB = Result.UsedMemoryDelta / (1024.0 * 1024.0);
+
+		double Ratio, MBPerSecond, MBPerSecondPerCore;
+		GetCompressionStats(Timings, Ratio, MBPerSecond, MBPerSecondPerCore);
+
+		//-1 without -llm
+		const double TrackedBytesPerRecord = Result.TrackedBytes >= 0 ? (double)Result.TrackedBytes / FMath::Max(Config.Actors + Config.Doors, 1) : -1.0;
+
+		Csv += FString::Printf(TEXT("%s,%s,%d,%s,%d,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%lld,%lld,%.3f,%.1f,%.1f,%.1f,%lld,%.3f\n"),
+			*Config.Build, *CodecName, Result.Run, *Result.Operation, Config.Actors, Config.Doors, Config.Components, Config.BlobBytes, Config.Items,
+			Result.WallSeconds * 1000.0, Timings.IterateSeconds * 1000.0, Timings.SerializeSeconds * 1000.0, Timings.WriteSeconds * 1000.0,
+			Timings.ReadSeconds * 1000.0, Timings.WorkerSeconds * 1000.0, Timings.MatchSeconds * 1000.0, Timings.SpawnSeconds * 1000.0, Timings.CompressSeconds * 1000.0,
+			Timings.BytesWritten, Timings.BytesUncompressed, Ratio, MBPerSecond, MBPerSecondPerCore, UsedMemoryDeltaMB, Result.TrackedBytes, TrackedBytesPerRecord);
+
+		Json += FString::Printf(TEXT("\t\t{ \"run\": %d, \"operation\": \"%s\", \"actors\": %d, \"doors\": %d, \"components\": %d, \"blobBytes\": %d, \"items\": %d, ")
+			TEXT("\"wallMs\": %.3f, \"iterateMs\": %.3f, \"serializeMs\": %.3f, \"writeMs\": %.3f, \"readMs\": %.3f, \"workerMs\": %.3f, \"matchMs\": %.3f, \"spawnMs\": %.3f, \"compressMs\": %.3f, ")
+			TEXT("\"bytesWritten\": %lld, \"bytesUncompressed\": %lld, \"compressionRatio\": %.3f, \"compressMBps\": %.1f, \"compressMBpsPerCore\": %.1f, \"usedMemoryDeltaMB\": %.1f, \"trackedBytes\": %lld, \"trackedBytesPerRecord\": %.3f }%s\n"),
+			Result.Run, *Result.Operation, Config.Actors, Config.Doors, Config.Components, Config.BlobBytes, Config.Items,
+			Result.WallSeconds * 1000.0, Timings.IterateSeconds * 1000.0, Timings.SerializeSeconds * 1000.0, Timings.WriteSeconds * 1000.0,
+			Timings.ReadSeconds * 1000.0, Timings.WorkerSeconds * 1000.0, Timings.MatchSeconds * 1000.0, Timings.SpawnSeconds * 1000.0, Timings.CompressSeconds * 1000.0,
+			Timings.BytesWritten, Timings.BytesUncompressed, Ratio, MBPerSecond, MBPerSecondPerCore, UsedMemoryDeltaMB, Result.TrackedBytes, TrackedBytesPerRecord,
+			i + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+	}
+
+	Json += TEXT("\t]\n}\n");
+
+	const FString CsvPath = Config.OutputDir / TEXT("SaveBenchmark.csv");
+	const FString JsonPath = Config.OutputDir / TEXT("SaveBenchmark.json");
+
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath) || !FFileHelper::SaveStringToFile(Json, *JsonPath))
+	{
+		UE_LOG(LogSaveBenchmark, Error, TEXT("Failed to write benchmark results to %s"), *Config.OutputDir);
+		return false;
+	}
+
+	UE_LOG(LogSaveBenchmark, Display, TEXT("Benchmark results written to %s and %s"), *CsvPath, *JsonPath);
+	return true;
+}
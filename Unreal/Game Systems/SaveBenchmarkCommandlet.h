@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SaveSubsystem.h"
+#include "SaveBenchmarkCommandlet.generated.h"
+
+class UGameInstance;
+class APhysicsDoor;
+
+struct FSaveBenchmarkConfig
+{
+	int32 Actors = 1000;
+	int32 Doors = 200;
+	int32 Components = 2;
+	int32 BlobBytes = 256;
+	int32 Items = 8;
+	int32 Iterations = 3;
+
+	ESaveChunkCodec Codec = ESaveChunkCodec::LZ4;
+	bool bParallelCompression = true;
+
+	//Off by default, pooled blobs are deduplicated and left out of the chunks, the codec would only see what is left
+	bool bPoolBlobs = false;
+
+	//Incompressible payloads, the worst case for the codecs. By default payloads are shaped like SaveGame property data
+	bool bRandomPayload = false;
+
+	//Blob pool of the benchmark, the pool of the profile is never touched
+	FString PoolPath;
+
+	FString Build;
+	FString OutputDir;
+	FString PlayerClassPath;
+};
+
+struct FSaveBenchmarkResult
+{
+	int32 Run = 0;
+
+	//Save, LoadDecode (the level chunk decoded without touching the world), LoadMatch (records applied to live actors),
+	//LoadMatchAsync (the same through LoadGameAsync) or LoadSpawn (every record respawned into an empty world)
+	FString Operation;
+
+	double WallSeconds = 0.0;
+
+	FSavePhaseTimings Timings;
+
+	//Physical memory in use after the operation minus before it, negative when it freed more than it kept
+	int64 UsedMemoryDelta = 0;
+
+	//Bytes the benchmark thread allocated during the operation and still holds, from the LLM tag of the benchmark. -1 without -llm
+	int64 TrackedBytes = -1;
+};
+
+/**
+ * Builds synthetic worlds and times USaveSubsystem on them, the results are written as CSV and JSON to diff between builds.
+ * Run headless: UE4Editor-Cmd <Project>.uproject -run=SaveBenchmark -nullrhi -unattended
+ * Options: -Actors= -Doors= -Components= -BlobBytes= -Items= -Iterations= -Build= -Out= -PlayerClass= -Codec=None|Zlib|LZ4|Oodle -SerialCompress
+ * -PoolBlobs -RandomPayload. Add -llm for the bytes each operation keeps, -trace=memory,bookmark to count its allocations in Memory Insights. Pooled runs write into a pool of their own in the output directory, deleted once the benchmark is done.
+ * -Verify runs the save and load scenarios in RunChecks instead and exits with 1 when any of them fails, for the build machine.
+ */
+UCLASS()
+class SHADOWOFTHEOTHERSIDE_API USaveBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USaveBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	void RunIteration(const FSaveBenchmarkConfig& Config, int32 Run, TArray<FSaveBenchmarkResult>& OutResults);
+
+	//Runs every check below, false when any of them failed
+	bool RunChecks(const FSaveBenchmarkConfig& Config);
+
+	//New game after a load, saved to another slot: the new slot holds the new session only and loads back as it was saved
+	bool CheckNewGameSave(const FSaveBenchmarkConfig& Config);
+
+	//A placed actor that was not moved writes no transform bytes and reads back at its placed transform, also after the level moved it
+	bool CheckPlacedTransform();
+
+	//LoadGameOnLevelLoad puts an unmoved placed actor at the transform its level now places it at, before its components register
+	bool CheckLevelLoadPlacedTransform(const FSaveBenchmarkConfig& Config);
+
+	//Adds a placed actor to the persistent level the way loading the level would, its components unregistered
+	static APhysicsDoor* AddPlacedDoor(UWorld* World, FName ActorName, const FTransform& Transform);
+
+	UGameInstance* CreateBenchmarkWorld(const FSaveBenchmarkConfig& Config);
+	void DestroyBenchmarkWorld(UGameInstance* GameInstance);
+
+	void PopulateWorld(UWorld* World, const FSaveBenchmarkConfig& Config, int32 Seed);
+
+	void AddResult(const FString& Operation, int32 Run, double WallSeconds, const FSavePhaseTimings& Timings, int64 TrackedBytes, uint64 UsedMemoryBefore, TArray<FSaveBenchmarkResult>& OutResults);
+
+	//Raw over written bytes, and how fast the chunks were compressed in total and on a single core
+	static void GetCompressionStats(const FSavePhaseTimings& Timings, double& OutRatio, double& OutMBPerSecond, double& OutMBPerSecondPerCore);
+
+	bool WriteResults(const FSaveBenchmarkConfig& Config, const TArray<FSaveBenchmarkResult>& Results);
+};
@@ -0,0 +1,603 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveBlobPool.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Hash/CityHash.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Templates/UniquePtr.h"
+#include "SaveSlotFile.h"
+#include "SaveNameTableArchive.h"
+
+const uint32 FSaveBlobPool::PoolTag = 0x4C4F4F50;
+const int32 FSaveBlobPool::PoolVersion = 2;
+const int32 FSaveBlobPool::MinPooledBlobBytes = 32;
+
+namespace SaveBlobPool
+{
+	//Tag + Version + Compacted Size
+	static const int64 HeaderSize = 16;
+
+	//Key + Size + Codec + Uncompressed Size
+	static const int64 RecordHeaderSize = 25;
+
+	//Key + Size, records before they were compressed
+	static const int64 RecordHeaderSizeRaw = 20;
+
+	//Records carry their codec from this version on
+	static const int32 VersionCompressedRecords = 2;
+
+	//Pools below this size are never compacted, scanning every slot costs more than the space it frees
+	static const int64 MinCompactBytes = 1024 * 1024;
+
+	static int64 GetRecordHeaderSize(int32 Version)
+	{
+		return Version >= VersionCompressedRecords ? RecordHeaderSize : RecordHeaderSizeRaw;
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FSaveBlobKey& Key)
+{
+	Ar << Key.Hash;
+	Ar << Key.Check;
+
+	return Ar;
+}
+
+FString FSaveBlobPool::GetPoolPath()
+{
+	return FString::Printf(TEXT("%sSaveGames/BlobPool.pool"), *FPaths::ProjectSavedDir());
+}
+
+FSaveBlobPool::FSaveBlobPool()
+	: Path(GetPoolPath())
+{
+}
+
+FSaveBlobPool::FSaveBlobPool(const FString& InPath)
+	: Path(InPath)
+{
+}
+
+void FSaveBlobPool::SetPath(const FString& InPath)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Path = InPath;
+
+	//The index belongs to the previous file, the next Open reads the new one
+	Index.Reset();
+	Pending.Reset();
+	Preloaded.Reset();
+	ValidSize = 0;
+	CompactedSize = 0;
+	bOpened = false;
+	bDamagedTail = false;
+}
+
+FSaveBlobKey FSaveBlobPool::MakeKey(const TArray<uint8>& Data, uint64 NameTableHash)
+{
+	//The signature is part of the hashed bytes as well, seeding with it keeps Hash and Check apart
+	uint64 Seed = NameTableHash;
+	FSaveNameTableArchive::GetNameSignature(Data, Seed);
+
+	FSaveBlobKey Key;
+	Key.Hash = CityHash64WithSeed((const char*)Data.GetData(), Data.Num(), Seed);
+	Key.Check = CityHash64((const char*)Data.GetData(), Data.Num());
+
+	return Key;
+}
+
+bool FSaveBlobPool::Open()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (bOpened)
+		return true;
+
+	if (!ReadIndex())
+		return false;
+
+	bOpened = true;
+	return true;
+}
+
+FSaveBlobKey FSaveBlobPool::Add(const TArray<uint8>& Data, uint64 NameTableHash)
+{
+	const FSaveBlobKey Key = MakeKey(Data, NameTableHash);
+
+	FScopeLock ScopeLock(&Lock);
+
+	if (!Index.Contains(Key) && !Pending.Contains(Key))
+		Pending.Add(Key, Data);
+
+	return Key;
+}
+
+bool FSaveBlobPool::ReadBlobs(const TArray<FSaveBlobKey>& Keys, TArray<TArray<uint8>>& OutData) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	OutData.SetNum(Keys.Num());
+
+	TUniquePtr<IFileHandle> Handle;
+	TArray<uint8> Scratch;
+
+	for (int32 i = 0; i < Keys.Num(); i++)
+	{
+		if (const TArray<uint8>* MemoryData = FindInMemory(Keys[i]))
+		{
+			OutData[i] = *MemoryData;
+			continue;
+		}
+
+		const FBlobLocation* Location = Index.Find(Keys[i]);
+
+		if (Location == nullptr)
+			return false;
+
+		if (!Handle.IsValid())
+			Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+
+		OutData[i].SetNumUninitialized(Location->UncompressedSize);
+
+		if (!Handle.IsValid() || !ReadBlob(Handle.Get(), *Location, Keys[i], OutData[i].GetData(), Scratch))
+			return false;
+	}
+
+	return true;
+}
+
+bool FSaveBlobPool::ReadBlobs(const TArray<FSaveBlobKey>& Keys, TArray<uint8>& OutArena, TArray<int64>& OutOffsets) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	OutOffsets.SetNumUninitialized(Keys.Num() + 1);
+
+	int64 ArenaSize = 0;
+
+	for (int32 i = 0; i < Keys.Num(); i++)
+	{
+		OutOffsets[i] = ArenaSize;
+
+		if (const TArray<uint8>* MemoryData = FindInMemory(Keys[i]))
+		{
+			ArenaSize += MemoryData->Num();
+			continue;
+		}
+
+		const FBlobLocation* Location = Index.Find(Keys[i]);
+
+		if (Location == nullptr)
+			return false;
+
+		ArenaSize += Location->UncompressedSize;
+	}
+
+	OutOffsets[Keys.Num()] = ArenaSize;
+	OutArena.SetNumUninitialized(ArenaSize);
+
+	TUniquePtr<IFileHandle> Handle;
+	TArray<uint8> Scratch;
+
+	for (int32 i = 0; i < Keys.Num(); i++)
+	{
+		uint8* BlobData = OutArena.GetData() + OutOffsets[i];
+		const int64 BlobSize = OutOffsets[i + 1] - OutOffsets[i];
+
+		if (const TArray<uint8>* MemoryData = FindInMemory(Keys[i]))
+		{
+			FMemory::Memcpy(BlobData, MemoryData->GetData(), BlobSize);
+			continue;
+		}
+
+		if (!Handle.IsValid())
+			Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+
+		if (!Handle.IsValid() || !ReadBlob(Handle.Get(), Index.FindChecked(Keys[i]), Keys[i], BlobData, Scratch))
+			return false;
+	}
+
+	return true;
+}
+
+int64 FSaveBlobPool::Preload(const TArray<FSaveBlobKey>& Keys, int64 MaxBytes)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	int64 PreloadedBytes = 0;
+
+	for (const TPair<FSaveBlobKey, TArray<uint8>>& Blob : Preloaded)
+	{
+		PreloadedBytes += Blob.Value.Num();
+	}
+
+	TUniquePtr<IFileHandle> Handle;
+	TArray<uint8> Scratch;
+
+	for (const FSaveBlobKey& Key : Keys)
+	{
+		if (FindInMemory(Key) != nullptr)
+			continue;
+
+		const FBlobLocation* Location = Index.Find(Key);
+
+		if (Location == nullptr)
+			continue;
+
+		if (PreloadedBytes + Location->UncompressedSize > MaxBytes)
+			break;
+
+		if (!Handle.IsValid())
+			Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+
+		if (!Handle.IsValid())
+			break;
+
+		TArray<uint8> Data;
+		Data.SetNumUninitialized(Location->UncompressedSize);
+
+		//A damaged blob is left to the load, which fails on it the same way without the preload
+		if (!ReadBlob(Handle.Get(), *Location, Key, Data.GetData(), Scratch))
+			continue;
+
+		PreloadedBytes += Data.Num();
+		Preloaded.Add(Key, MoveTemp(Data));
+	}
+
+	return PreloadedBytes;
+}
+
+const TArray<uint8>* FSaveBlobPool::FindInMemory(const FSaveBlobKey& Key) const
+{
+	if (const TArray<uint8>* PendingData = Pending.Find(Key))
+		return PendingData;
+
+	return Preloaded.Find(Key);
+}
+
+bool FSaveBlobPool::ReadBlob(IFileHandle* Handle, const FBlobLocation& Location, const FSaveBlobKey& Key, uint8* OutData, TArray<uint8>& Scratch)
+{
+	if (Location.Codec == ESaveChunkCodec::None)
+	{
+		if (Location.Size != Location.UncompressedSize || !Handle->Seek(Location.Offset) || !Handle->Read(OutData, Location.Size))
+			return false;
+	}
+	else
+	{
+		Scratch.SetNumUninitialized(Location.Size);
+
+		if (!Handle->Seek(Location.Offset) || !Handle->Read(Scratch.GetData(), Location.Size)
+			|| !FSaveSlotFile::DecompressMemory(Location.Codec, Scratch, OutData, Location.UncompressedSize))
+			return false;
+	}
+
+	//A record cut short by a crash reads back as different bytes
+	return CityHash64((const char*)OutData, Location.UncompressedSize) == Key.Check;
+}
+
+bool FSaveBlobPool::Flush(ESaveChunkCodec Codec)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (Pending.Num() == 0)
+		return true;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*Path, ValidSize > 0, true));
+
+	if (!Handle.IsValid())
+		return false;
+
+	if (ValidSize == 0)
+	{
+		FileVersion = PoolVersion;
+
+		if (!WriteHeader(Handle.Get(), 0))
+			return false;
+
+		ValidSize = SaveBlobPool::HeaderSize;
+	}
+
+	//Records behind ValidSize never completed, they are overwritten
+	if (!Handle->Seek(ValidSize))
+		return false;
+
+	//An older pool keeps taking raw records until the next compaction rewrites it
+	const ESaveChunkCodec RecordCodec = FileVersion >= SaveBlobPool::VersionCompressedRecords ? Codec : ESaveChunkCodec::None;
+
+	FSaveChunkData Record;
+
+	for (TPair<FSaveBlobKey, TArray<uint8>>& Blob : Pending)
+	{
+		FSaveSlotFile::CompressChunk(ESaveChunkType::Level, NAME_None, Blob.Value, RecordCodec, Record);
+
+		FBlobLocation Location;
+
+		if (!WriteRecord(Handle.Get(), ValidSize, Blob.Key, Record.Data, Record.Codec, Blob.Value.Num(), Location))
+			return false;
+
+		Index.Add(Blob.Key, Location);
+		ValidSize = Location.Offset + Location.Size;
+	}
+
+	Pending.Reset();
+
+	return Handle->Flush();
+}
+
+bool FSaveBlobPool::WriteRecord(IFileHandle* Handle, int64 Offset, const FSaveBlobKey& Key, const TArray<uint8>& StoredData, ESaveChunkCodec Codec, int32 UncompressedSize, FBlobLocation& OutLocation) const
+{
+	TArray<uint8> RecordHeader;
+	FMemoryWriter Writer(RecordHeader);
+
+	FSaveBlobKey RecordKey = Key;
+	int32 Size = StoredData.Num();
+
+	Writer << RecordKey;
+	Writer << Size;
+
+	if (FileVersion >= SaveBlobPool::VersionCompressedRecords)
+	{
+		uint8 CodecValue = (uint8)Codec;
+
+		Writer << CodecValue;
+		Writer << UncompressedSize;
+	}
+
+	if (!Handle->Write(RecordHeader.GetData(), RecordHeader.Num()) || !Handle->Write(StoredData.GetData(), Size))
+		return false;
+
+	OutLocation.Offset = Offset + RecordHeader.Num();
+	OutLocation.Size = Size;
+	OutLocation.UncompressedSize = UncompressedSize;
+	OutLocation.Codec = Codec;
+
+	return true;
+}
+
+bool FSaveBlobPool::ShouldCompact() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (ValidSize > 0 && FileVersion < PoolVersion)
+		return true;
+
+	return bDamagedTail || ValidSize > FMath::Max(CompactedSize * 2, SaveBlobPool::MinCompactBytes);
+}
+
+bool FSaveBlobPool::Compact(ESaveChunkCodec Codec)
+{
+	TSet<FSaveBlobKey> ScannedKeys;
+
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		//Nothing was ever appended, the next Flush starts the file over
+		if (ValidSize == 0)
+			return true;
+
+		Index.GetKeys(ScannedKeys);
+	}
+
+	//Reading every slot is the slow part, loads and saves keep using the pool meanwhile
+	TSet<FSaveBlobKey> LiveKeys;
+
+	TArray<FString> SlotNames;
+	FSaveSlotFile::FindSlotNames(SlotNames);
+
+	TArray<FSaveBlobKey> ChunkKeys;
+
+	for (const FString& SlotName : SlotNames)
+	{
+		FSaveSlotFile SlotFile;
+
+		//Legacy slots don't reference the pool
+		if (!SlotFile.Open(SlotName))
+			continue;
+
+		for (const FSaveChunkEntry& Entry : SlotFile.GetEntries())
+		{
+			if (Entry.Type != ESaveChunkType::Level || Entry.Encoding != ESaveChunkEncoding::NameTablePooled)
+				continue;
+
+			//Better to keep garbage than to drop a blob an unreadable chunk might still need
+			if (!SlotFile.ReadPooledBlobKeys(Entry, ChunkKeys))
+				return false;
+
+			LiveKeys.Append(ChunkKeys);
+		}
+	}
+
+	FScopeLock ScopeLock(&Lock);
+
+	//Blobs waiting to be written or appended during the scan may belong to a slot that isn't on disk yet
+	for (const TPair<FSaveBlobKey, TArray<uint8>>& Blob : Pending)
+	{
+		LiveKeys.Add(Blob.Key);
+	}
+
+	for (const TPair<FSaveBlobKey, FBlobLocation>& Blob : Index)
+	{
+		if (!ScannedKeys.Contains(Blob.Key))
+			LiveKeys.Add(Blob.Key);
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	const FString PoolPath = Path;
+	const FString TempPath = PoolPath + TEXT(".tmp");
+
+	const int32 SourceVersion = FileVersion;
+	const ESaveChunkCodec RecordCodec = SourceVersion >= SaveBlobPool::VersionCompressedRecords ? ESaveChunkCodec::None : Codec;
+
+	TMap<FSaveBlobKey, FBlobLocation> NewIndex;
+	int64 NewSize = SaveBlobPool::HeaderSize;
+
+	//Records are written in the current layout
+	FileVersion = PoolVersion;
+
+	{
+		TUniquePtr<IFileHandle> Source(PlatformFile.OpenRead(*PoolPath));
+		TUniquePtr<IFileHandle> Target(PlatformFile.OpenWrite(*TempPath));
+
+		if (!Source.IsValid() || !Target.IsValid() || !WriteHeader(Target.Get(), 0))
+		{
+			FileVersion = SourceVersion;
+			return false;
+		}
+
+		TArray<uint8> StoredData;
+		FSaveChunkData Record;
+
+		for (const TPair<FSaveBlobKey, FBlobLocation>& Blob : Index)
+		{
+			if (!LiveKeys.Contains(Blob.Key))
+				continue;
+
+			StoredData.SetNumUninitialized(Blob.Value.Size);
+
+			if (!Source->Seek(Blob.Value.Offset) || !Source->Read(StoredData.GetData(), StoredData.Num()))
+			{
+				FileVersion = SourceVersion;
+				return false;
+			}
+
+			//Raw records of an older pool are compressed on the way, compressed ones are copied as they are
+			ESaveChunkCodec StoredCodec = Blob.Value.Codec;
+
+			if (RecordCodec != ESaveChunkCodec::None && StoredCodec == ESaveChunkCodec::None)
+			{
+				FSaveSlotFile::CompressChunk(ESaveChunkType::Level, NAME_None, StoredData, RecordCodec, Record);
+
+				StoredData = MoveTemp(Record.Data);
+				StoredCodec = Record.Codec;
+			}
+
+			FBlobLocation Location;
+
+			if (!WriteRecord(Target.Get(), NewSize, Blob.Key, StoredData, StoredCodec, Blob.Value.UncompressedSize, Location))
+			{
+				FileVersion = SourceVersion;
+				return false;
+			}
+
+			NewIndex.Add(Blob.Key, Location);
+			NewSize = Location.Offset + Location.Size;
+		}
+
+		if (!Target->Seek(0) || !WriteHeader(Target.Get(), NewSize))
+		{
+			FileVersion = SourceVersion;
+			return false;
+		}
+	}
+
+	if (!IFileManager::Get().Move(*PoolPath, *TempPath, true))
+	{
+		FileVersion = SourceVersion;
+		return false;
+	}
+
+	Index = MoveTemp(NewIndex);
+	ValidSize = NewSize;
+	CompactedSize = NewSize;
+	bDamagedTail = false;
+
+	return true;
+}
+
+bool FSaveBlobPool::ReadIndex()
+{
+	Index.Reset();
+	ValidSize = 0;
+	CompactedSize = 0;
+	FileVersion = PoolVersion;
+	bDamagedTail = false;
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Path));
+
+	if (!Reader.IsValid())
+		return true;
+
+	const int64 FileSize = Reader->TotalSize();
+
+	//A pool that never finished its header is started over
+	if (FileSize < SaveBlobPool::HeaderSize)
+	{
+		bDamagedTail = FileSize > 0;
+		return true;
+	}
+
+	uint32 Tag = 0;
+	int32 Version = 0;
+
+	*Reader << Tag;
+	*Reader << Version;
+	*Reader << CompactedSize;
+
+	if (Tag != PoolTag || Version > PoolVersion)
+		return false;
+
+	FileVersion = Version;
+
+	const int64 RecordHeaderSize = SaveBlobPool::GetRecordHeaderSize(Version);
+	int64 Offset = SaveBlobPool::HeaderSize;
+
+	while (Offset + RecordHeaderSize <= FileSize)
+	{
+		FSaveBlobKey Key;
+		int32 Size = 0;
+
+		Reader->Seek(Offset);
+		*Reader << Key;
+		*Reader << Size;
+
+		FBlobLocation Location;
+		Location.Offset = Offset + RecordHeaderSize;
+		Location.Size = Size;
+		Location.UncompressedSize = Size;
+		Location.Codec = ESaveChunkCodec::None;
+
+		if (Version >= SaveBlobPool::VersionCompressedRecords)
+		{
+			uint8 CodecValue = 0;
+
+			*Reader << CodecValue;
+			*Reader << Location.UncompressedSize;
+
+			Location.Codec = (ESaveChunkCodec)CodecValue;
+		}
+
+		if (Reader->IsError() || Size < 0 || Location.UncompressedSize < 0 || Location.Offset + Size > FileSize)
+			break;
+
+		Index.Add(Key, Location);
+		Offset = Location.Offset + Size;
+	}
+
+	ValidSize = Offset;
+	bDamagedTail = Offset != FileSize;
+
+	return true;
+}
+
+bool FSaveBlobPool::WriteHeader(IFileHandle* Handle, int64 InCompactedSize) const
+{
+	TArray<uint8> HeaderData;
+	FMemoryWriter Writer(HeaderData);
+
+	uint32 Tag = PoolTag;
+	int32 Version = FileVersion;
+
+	Writer << Tag;
+	Writer << Version;
+	Writer << InCompactedSize;
+
+	return Handle->Write(HeaderData.GetData(), HeaderData.Num());
+}
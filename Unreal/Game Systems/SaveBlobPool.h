@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+enum class ESaveChunkCodec : uint8;
+
+//Identifies one blob in the pool by its contents
+struct FSaveBlobKey
+{
+	//Hash of the blob seeded with the names it references, the same bytes only mean the same thing under the same names.
+	//Blobs from before the name signature are seeded with the whole name table they were written with
+	uint64 Hash = 0;
+
+	//Unseeded hash of the blob, checked again when the blob is read back
+	uint64 Check = 0;
+
+	FORCEINLINE bool operator==(const FSaveBlobKey& Other) const { return Hash == Other.Hash && Check == Other.Check; }
+
+	friend FORCEINLINE uint32 GetTypeHash(const FSaveBlobKey& Key) { return (uint32)Key.Hash; }
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveBlobKey& Key);
+};
+
+/**
+ * Content addressed store shared by every save slot of the profile.
+ * Level chunks reference their actor and component blobs by key, so a blob that is identical across levels or slots is written once.
+ * Layout: [Tag][Version][Compacted Size] followed by [Key][Size][Codec][Uncompressed Size][Data] records, new blobs are only ever appended.
+ * Every record is compressed on its own with the codec of the slot that added it. Version 1 pools hold [Key][Size][Data] records
+ * and are rewritten in the current layout by the next compaction.
+ * Blobs no slot references anymore are dropped when the pool is compacted.
+ */
+class SHADOWOFTHEOTHERSIDE_API FSaveBlobPool
+{
+public:
+
+	static const uint32 PoolTag;
+	static const int32 PoolVersion;
+
+	//Blobs smaller than this are stored inline in the chunk, a key would cost more than it saves
+	static const int32 MinPooledBlobBytes;
+
+public:
+
+	//Pool of the profile, every save slot shares it
+	static FString GetPoolPath();
+
+public:
+
+	FSaveBlobPool();
+
+	//A pool in another file, for tools and benchmarks that must leave the profile's pool alone
+	explicit FSaveBlobPool(const FString& InPath);
+
+	//Points the pool at another file, what was read or queued for the previous one is dropped
+	void SetPath(const FString& InPath);
+
+	FORCEINLINE const FString& GetPath() const { return Path; }
+
+	//NameTableHash only seeds blobs without a name signature
+	static FSaveBlobKey MakeKey(const TArray<uint8>& Data, uint64 NameTableHash);
+
+	//Reads the record headers of the pool file once, later calls do nothing
+	bool Open();
+
+	//Returns the key of Data and queues it for the next Flush unless the pool already holds it
+	FSaveBlobKey Add(const TArray<uint8>& Data, uint64 NameTableHash);
+
+	//Reads every blob in Keys with a single file handle, fails when one is missing or damaged
+	bool ReadBlobs(const TArray<FSaveBlobKey>& Keys, TArray<TArray<uint8>>& OutData) const;
+
+	//Reads every blob in Keys back to back into OutArena, blob i spans OutOffsets[i] to OutOffsets[i + 1].
+	//One allocation for the whole level instead of one per blob
+	bool ReadBlobs(const TArray<FSaveBlobKey>& Keys, TArray<uint8>& OutArena, TArray<int64>& OutOffsets) const;
+
+	//Reads the blobs in Keys into memory ahead of a load, later reads take them from there instead of the file.
+	//Stops at the first blob that would take it over MaxBytes and returns the bytes held. Open has to have succeeded
+	int64 Preload(const TArray<FSaveBlobKey>& Keys, int64 MaxBytes);
+
+	//Compresses and appends the queued blobs, has to succeed before a slot referencing them is written
+	bool Flush(ESaveChunkCodec Codec);
+
+	//True once appended blobs outweigh what was live at the last compaction, or the pool is still in an older layout
+	bool ShouldCompact() const;
+
+	//Rewrites the pool with only the blobs still referenced by a slot on disk, records of an older layout are compressed with Codec.
+	//The slots are scanned without holding the pool
+	bool Compact(ESaveChunkCodec Codec);
+
+private:
+
+	struct FBlobLocation
+	{
+		int64 Offset = 0;
+
+		//Bytes stored in the file
+		int32 Size = 0;
+
+		int32 UncompressedSize = 0;
+
+		ESaveChunkCodec Codec = (ESaveChunkCodec)0;
+	};
+
+	bool ReadIndex();
+
+	//Queued or preloaded copy of Key, null when it has to be read from the file. Lock has to be held
+	const TArray<uint8>* FindInMemory(const FSaveBlobKey& Key) const;
+
+	bool WriteHeader(IFileHandle* Handle, int64 CompactedSize) const;
+
+	//Writes one record in the layout of FileVersion at Offset, OutLocation gets where its data went
+	bool WriteRecord(IFileHandle* Handle, int64 Offset, const FSaveBlobKey& Key, const TArray<uint8>& StoredData, ESaveChunkCodec Codec, int32 UncompressedSize, FBlobLocation& OutLocation) const;
+
+	//Reads and decompresses the blob at Location into OutData, which has room for its uncompressed size
+	static bool ReadBlob(IFileHandle* Handle, const FBlobLocation& Location, const FSaveBlobKey& Key, uint8* OutData, TArray<uint8>& Scratch);
+
+private:
+
+	FString Path;
+
+	TMap<FSaveBlobKey, FBlobLocation> Index;
+
+	TMap<FSaveBlobKey, TArray<uint8>> Pending;
+
+	//Decompressed blobs read ahead by Preload
+	TMap<FSaveBlobKey, TArray<uint8>> Preloaded;
+
+	//End of the last complete record, anything behind it is the remains of an interrupted append
+	int64 ValidSize = 0;
+
+	int64 CompactedSize = 0;
+
+	//Layout of the pool file, appends keep it until the next compaction
+	int32 FileVersion = 0;
+
+	bool bOpened = false;
+
+	bool bDamagedTail = false;
+
+	mutable FCriticalSection Lock;
+};
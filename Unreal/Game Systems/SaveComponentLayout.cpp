@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveComponentLayout.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace SaveComponentLayout
+{
+	//Shared so an actor keeps the layout it was sorted with while the class's entry is grown
+	TMap<TWeakObjectPtr<UClass>, FSaveComponentLayoutRef> LayoutCache;
+
+	//Classes go away with the world that loaded them, or are replaced when Blueprints are recompiled or code is reloaded.
+	//Their layouts would never be looked up again, so the cache starts over; records are still found by name until it is rebuilt
+	static void RegisterCacheReset()
+	{
+		static bool bRegistered = false;
+
+		if (bRegistered)
+			return;
+
+		bRegistered = true;
+
+		FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* World, bool bSessionEnded, bool bCleanupResources)
+			{
+				LayoutCache.Reset();
+			});
+
+		FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason Reason)
+			{
+				LayoutCache.Reset();
+			});
+	}
+
+	FSaveComponentLayoutRef Get(AActor* Actor, const TArray<UActorComponent*>& Components)
+	{
+		check(IsInGameThread());
+
+		RegisterCacheReset();
+
+		UClass* Class = Actor->GetClass();
+		const FSaveComponentLayoutRef* Cached = LayoutCache.Find(Class);
+
+		TArray<FName> Missing;
+
+		for (UActorComponent* Component : Components)
+		{
+			if (Cached == nullptr || (*Cached)->Find(Component->GetFName()) == INDEX_NONE)
+				Missing.AddUnique(Component->GetFName());
+		}
+
+		if (Missing.Num() == 0 && Cached != nullptr)
+			return *Cached;
+
+		Missing.Sort(FNameLexicalLess());
+
+		TSharedRef<FSaveComponentLayout> Layout = Cached != nullptr ? MakeShared<FSaveComponentLayout>(**Cached) : MakeShared<FSaveComponentLayout>();
+
+		for (FName Name : Missing)
+		{
+			Layout->Indices.Add(Name, Layout->Names.Add(Name));
+		}
+
+		return LayoutCache.Add(Class, Layout);
+	}
+
+	void Sort(const FSaveComponentLayout& Layout, TArray<UActorComponent*>& Components)
+	{
+		//INDEX_NONE wraps to the largest index, unknown components keep their order behind the known ones
+		Components.StableSort([&Layout](const UActorComponent& A, const UActorComponent& B)
+		{
+			const uint32 IndexA = Layout.Find(A.GetFName());
+			const uint32 IndexB = Layout.Find(B.GetFName());
+
+			return IndexA < IndexB;
+		});
+	}
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UActorComponent;
+
+/**
+ * Saveable components of one actor class, in the order their records are written.
+ * Built once per class from the first actor of it that is seen, names are sorted so every session builds the same layout for the same components.
+ * Components found later on another actor of the class are appended, so an index never changes once it was handed out.
+ * The cache is dropped when a world is cleaned up or classes are reloaded, a layout only lives as long as the classes of its world.
+ */
+struct FSaveComponentLayout
+{
+	TArray<FName> Names;
+
+	TMap<FName, int32> Indices;
+
+	FORCEINLINE int32 Find(FName Name) const
+	{
+		const int32* Index = Indices.Find(Name);
+		return Index != nullptr ? *Index : INDEX_NONE;
+	}
+};
+
+//Layouts are only built and read on the game thread
+typedef TSharedRef<const FSaveComponentLayout> FSaveComponentLayoutRef;
+
+namespace SaveComponentLayout
+{
+	//Layout of Actor's class, grown first if Components holds a component the layout doesn't know yet
+	SHADOWOFTHEOTHERSIDE_API FSaveComponentLayoutRef Get(AActor* Actor, const TArray<UActorComponent*>& Components);
+
+	//Puts Components in layout order, so the record of the component at layout index i is written at index i
+	SHADOWOFTHEOTHERSIDE_API void Sort(const FSaveComponentLayout& Layout, TArray<UActorComponent*>& Components);
+
+	//Record saved for the component called Name, or INDEX_NONE
+	//Records written in layout order are found at the layout index, anything else (older slots, actors missing a component) is searched by name
+	template<typename RecordType>
+	int32 FindRecord(const FSaveComponentLayout& Layout, TArrayView<const RecordType> Records, const TBitArray<>& Applied, FName Name)
+	{
+		const int32 LayoutIndex = Layout.Find(Name);
+
+		if (Records.IsValidIndex(LayoutIndex) && !Applied[LayoutIndex] && Records[LayoutIndex].ComponentName == Name)
+			return LayoutIndex;
+
+		for (int32 i = 0; i < Records.Num(); i++)
+		{
+			if (!Applied[i] && Records[i].ComponentName == Name)
+				return i;
+		}
+
+		return INDEX_NONE;
+	}
+}
@@ -0,0 +1,649 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveInspectCommandlet.h"
+#include "SaveSubsystem.h"
+#include "SaveLevelView.h"
+#include "SaveNameTableArchive.h"
+#include "SaveBlobPool.h"
+#include "MainSaveGame.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveInspect, Log, All);
+
+namespace SaveInspect
+{
+	//Records whose class no longer loads in this build
+	static const FName UnresolvedClassName = FName("Unresolved");
+
+	static const TCHAR* GetEncodingName(ESaveChunkEncoding Encoding)
+	{
+		switch (Encoding)
+		{
+			case ESaveChunkEncoding::NameAsString:
+				return TEXT("NameAsString");
+
+			case ESaveChunkEncoding::NameTable:
+				return TEXT("NameTable");
+
+			case ESaveChunkEncoding::NameTableDelta:
+				return TEXT("NameTableDelta");
+
+			case ESaveChunkEncoding::NameTablePooled:
+				return TEXT("NameTablePooled");
+
+			default:
+				return TEXT("Unknown");
+		}
+	}
+
+	static int64 GetComponentBytes(const TArray<FActorComponentSaveData>& Components)
+	{
+		int64 Bytes = 0;
+
+		for (const FActorComponentSaveData& Component : Components)
+		{
+			Bytes += Component.BinaryData.Num();
+		}
+
+		return Bytes;
+	}
+
+	static int64 GetPlayerBytes(const FPlayerSavedata& PlayerData)
+	{
+		return PlayerData.CharacterBinaryData.Num() + PlayerData.ControllerBinaryData.Num() + PlayerData.ControllerCustomData.Num()
+			+ GetComponentBytes(PlayerData.CharacterComponentsSaveData) + GetComponentBytes(PlayerData.ControllerComponentsSaveData);
+	}
+
+	static bool SameBytes(TArrayView<const uint8> A, TArrayView<const uint8> B)
+	{
+		return A.Num() == B.Num() && FMemory::Memcmp(A.GetData(), B.GetData(), A.Num()) == 0;
+	}
+
+	static bool SameComponents(const TArray<FActorComponentSaveData>& A, const TArray<FActorComponentSaveData>& B)
+	{
+		if (A.Num() != B.Num())
+			return false;
+
+		for (int32 i = 0; i < A.Num(); i++)
+		{
+			if (A[i].ComponentName != B[i].ComponentName || !SameBytes(A[i].BinaryData, B[i].BinaryData))
+				return false;
+		}
+
+		return true;
+	}
+
+	static double ToMB(int64 Bytes)
+	{
+		return Bytes / (1024.0 * 1024.0);
+	}
+}
+
+USaveInspectCommandlet::USaveInspectCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 USaveInspectCommandlet::Main(const FString& Params)
+{
+	FSaveInspectConfig Config;
+
+	FString SlotList;
+
+	if (FParse::Value(*Params, TEXT("Slot="), SlotList))
+		SlotList.ParseIntoArray(Config.SlotNames, TEXT("+"));
+
+	if (FParse::Param(*Params, TEXT("AllSlots")))
+	{
+		TArray<FString> SlotNames;
+		FSaveSlotFile::FindSlotNames(SlotNames);
+
+		for (const FString& SlotName : SlotNames)
+		{
+			Config.SlotNames.AddUnique(SlotName);
+		}
+	}
+
+	FParse::Value(*Params, TEXT("Iterations="), Config.Iterations);
+	FParse::Value(*Params, TEXT("Top="), Config.Top);
+
+	Config.bConvert = FParse::Param(*Params, TEXT("Convert"));
+	Config.bInPlace = FParse::Param(*Params, TEXT("InPlace"));
+	Config.bPool = !FParse::Param(*Params, TEXT("NoPool"));
+
+	FString CodecName;
+
+	if (FParse::Value(*Params, TEXT("Codec="), CodecName))
+	{
+		const int64 CodecValue = StaticEnum<ESaveChunkCodec>()->GetValueByNameString(CodecName);
+
+		if (CodecValue == INDEX_NONE)
+			UE_LOG(LogSaveInspect, Warning, TEXT("Unknown codec %s, using %s"), *CodecName, *StaticEnum<ESaveChunkCodec>()->GetNameStringByValue((int64)Config.Codec));
+		else
+			Config.Codec = (ESaveChunkCodec)CodecValue;
+	}
+
+	Config.Codec = FSaveSlotFile::GetAvailableCodec(Config.Codec);
+
+	if (!FParse::Value(*Params, TEXT("Out="), Config.OutputDir))
+		Config.OutputDir = FPaths::ProjectSavedDir() / TEXT("SaveInspect");
+
+	if (!FParse::Value(*Params, TEXT("Pool="), Config.PoolPath))
+		Config.PoolPath = FSaveBlobPool::GetPoolPath();
+
+	//The game only ever reads the pool of the profile, slots converted into another one have to be copied back along with it
+	if (Config.bConvert && Config.bPool && Config.PoolPath != FSaveBlobPool::GetPoolPath())
+		UE_LOG(LogSaveInspect, Warning, TEXT("Converted slots reference blobs in %s, not in the pool of the profile"), *Config.PoolPath);
+
+	if (Config.SlotNames.Num() == 0)
+	{
+		UE_LOG(LogSaveInspect, Error, TEXT("No slot given, pass -Slot=<Name>[+<Name>...] or -AllSlots"));
+		return 1;
+	}
+
+	TArray<FSaveInspectSlot> Slots;
+	bool bFailed = false;
+
+	for (const FString& SlotName : Config.SlotNames)
+	{
+		FSaveInspectSlot Slot;
+
+		if (!InspectSlot(Config, SlotName, Slot))
+		{
+			UE_LOG(LogSaveInspect, Error, TEXT("%s could not be read"), *SlotName);
+			bFailed = true;
+			continue;
+		}
+
+		if (Config.Iterations > 0)
+			BenchmarkDecode(Config, Slot);
+
+		if (Config.bConvert && !ConvertSlot(Config, Slot))
+			bFailed = true;
+
+		LogSlot(Config, Slot);
+		Slots.Add(MoveTemp(Slot));
+	}
+
+	return WriteResults(Config, Slots) && !bFailed ? 0 : 1;
+}
+
+bool USaveInspectCommandlet::InspectSlot(const FSaveInspectConfig& Config, const FString& SlotName, FSaveInspectSlot& OutSlot)
+{
+	OutSlot.SlotName = SlotName;
+	OutSlot.FileBytes = IFileManager::Get().FileSize(*FSaveSlotFile::GetSlotPath(SlotName));
+
+	FSaveSlotFile SlotFile;
+
+	//Slots from before the chunked layout are one save object, its levels are viewed in place
+	if (!SlotFile.Open(SlotName))
+	{
+		UMainSaveGame* LegacySaveGame = USaveSubsystem::LoadLegacySlot(SlotName);
+
+		if (LegacySaveGame == nullptr)
+			return false;
+
+		OutSlot.PlayerBytes = SaveInspect::GetPlayerBytes(LegacySaveGame->PlayerData);
+
+		for (const TPair<FName, FLevelSaveData>& Pair : LegacySaveGame->WorldActorData)
+		{
+			FSaveLevelView View;
+			View.Reference(Pair.Value);
+
+			AddLevel(Pair.Key, View, OutSlot, OutSlot.Levels.AddDefaulted_GetRef());
+		}
+
+		return true;
+	}
+
+	FSaveSlotInfo Info;
+
+	if (FSaveSlotFile::ReadSlotInfo(SlotName, Info))
+		OutSlot.FormatVersion = Info.FormatVersion;
+
+	FSaveNameTable NameTable;
+	FPlayerSavedata PlayerData;
+
+	if (!SlotFile.ReadNameTableChunk(NameTable) || !SlotFile.ReadPlayerChunk(PlayerData, NameTable))
+		return false;
+
+	OutSlot.NameTableEntries = NameTable.Num();
+	OutSlot.PlayerBytes = SaveInspect::GetPlayerBytes(PlayerData);
+
+	FSaveBlobPool Pool(Config.PoolPath);
+	const FSaveBlobPool* LevelPool = Pool.Open() ? &Pool : nullptr;
+
+	for (const FSaveChunkEntry& Entry : SlotFile.GetEntries())
+	{
+		if (Entry.Type != ESaveChunkType::Level)
+			continue;
+
+		FSaveLevelView View;
+
+		if (!SlotFile.ReadLevelView(Entry.Key, View, NameTable, LevelPool))
+		{
+			UE_LOG(LogSaveInspect, Warning, TEXT("%s: level %s could not be decoded"), *SlotName, *Entry.Key.ToString());
+			continue;
+		}
+
+		FSaveInspectLevel& Level = OutSlot.Levels.AddDefaulted_GetRef();
+		Level.Encoding = SaveInspect::GetEncodingName(Entry.Encoding);
+		Level.Codec = StaticEnum<ESaveChunkCodec>()->GetNameStringByValue((int64)Entry.Codec);
+		Level.ChunkBytes = Entry.Size;
+		Level.UncompressedBytes = Entry.UncompressedSize;
+
+		AddLevel(Entry.Key, View, OutSlot, Level);
+	}
+
+	return true;
+}
+
+void USaveInspectCommandlet::AddLevel(FName LevelName, const FSaveLevelView& View, FSaveInspectSlot& Slot, FSaveInspectLevel& OutLevel)
+{
+	OutLevel.LevelName = LevelName;
+	OutLevel.Actors = View.Num();
+
+	for (int32 i = 0; i < View.Num(); i++)
+	{
+		const FSaveActorView& Record = View.GetActor(i);
+
+		const FName ClassName = Record.ActorClass != nullptr ? Record.ActorClass->GetFName() : SaveInspect::UnresolvedClassName;
+		const int64 RecordBytes = View.GetRecordBytes(Record);
+
+		FSaveInspectActor& Actor = Slot.Actors.AddDefaulted_GetRef();
+		Actor.LevelName = LevelName;
+		Actor.ActorName = Record.ActorName;
+		Actor.ClassName = ClassName;
+		Actor.Components = Record.NumComponents;
+		Actor.ActorBytes = Record.BinaryData.Num();
+		Actor.ComponentBytes = RecordBytes - Actor.ActorBytes;
+
+		OutLevel.Components += Record.NumComponents;
+		OutLevel.ActorBlobBytes += Actor.ActorBytes;
+		OutLevel.ComponentBlobBytes += Actor.ComponentBytes;
+
+		FSaveInspectClass& Class = Slot.Classes.FindOrAdd(ClassName);
+		Class.ClassName = ClassName;
+		Class.Actors++;
+		Class.Components += Record.NumComponents;
+		Class.Bytes += RecordBytes;
+		Class.LargestRecordBytes = FMath::Max(Class.LargestRecordBytes, RecordBytes);
+	}
+}
+
+void USaveInspectCommandlet::BenchmarkDecode(const FSaveInspectConfig& Config, FSaveInspectSlot& Slot)
+{
+	FSaveBlobPool Pool(Config.PoolPath);
+	const FSaveBlobPool* LevelPool = Pool.Open() ? &Pool : nullptr;
+
+	double TotalSeconds = 0.0;
+	Slot.DecodeMinSeconds = MAX_dbl;
+
+	//The first pass also warms the file cache, the fastest pass is the decode cost on its own
+	for (int32 Run = 0; Run < Config.Iterations; Run++)
+	{
+		int64 DecodedBytes = 0;
+		int32 Records = 0;
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		FSaveSlotFile SlotFile;
+
+		if (SlotFile.Open(Slot.SlotName))
+		{
+			FSaveNameTable NameTable;
+			FPlayerSavedata PlayerData;
+
+			SlotFile.ReadNameTableChunk(NameTable);
+			SlotFile.ReadPlayerChunk(PlayerData, NameTable);
+
+			for (const FSaveChunkEntry& Entry : SlotFile.GetEntries())
+			{
+				DecodedBytes += Entry.UncompressedSize;
+
+				if (Entry.Type != ESaveChunkType::Level)
+					continue;
+
+				FSaveLevelView View;
+
+				if (SlotFile.ReadLevelView(Entry.Key, View, NameTable, LevelPool))
+					Records += View.Num();
+			}
+		}
+		else if (UMainSaveGame* LegacySaveGame = USaveSubsystem::LoadLegacySlot(Slot.SlotName))
+		{
+			DecodedBytes = Slot.FileBytes;
+
+			for (const TPair<FName, FLevelSaveData>& Pair : LegacySaveGame->WorldActorData)
+			{
+				Records += Pair.Value.LevelActorData.Num();
+			}
+		}
+
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		TotalSeconds += Seconds;
+		Slot.DecodeMinSeconds = FMath::Min(Slot.DecodeMinSeconds, Seconds);
+		Slot.DecodedBytes = DecodedBytes;
+		Slot.Records = Records;
+	}
+
+	Slot.DecodeAverageSeconds = TotalSeconds / Config.Iterations;
+}
+
+bool USaveInspectCommandlet::ReadSlotRecords(const FString& SlotName, const FString& PoolPath, FSaveNameTable& OutNameTable, FPlayerSavedata& OutPlayerData, TMap<FName, FLevelSaveData>& OutLevels,
+	TMap<FName, FSavePlacedTransforms>& OutPlaced, FSaveSlotInfo& OutInfo)
+{
+	FSaveSlotFile SlotFile;
+
+	if (!SlotFile.Open(SlotName))
+	{
+		UMainSaveGame* LegacySaveGame = USaveSubsystem::LoadLegacySlot(SlotName);
+
+		if (LegacySaveGame == nullptr)
+			return false;
+
+		OutNameTable.Reset();
+		OutPlayerData = LegacySaveGame->PlayerData;
+		OutLevels = LegacySaveGame->WorldActorData;
+
+		OutInfo = FSaveSlotInfo();
+		OutInfo.LevelName = OutPlayerData.CurrentLevel;
+		OutInfo.PlayerTransform = OutPlayerData.PlayerTransform;
+		OutInfo.Timestamp = IFileManager::Get().GetTimeStamp(*FSaveSlotFile::GetSlotPath(SlotName));
+
+		return true;
+	}
+
+	if (!SlotFile.ReadNameTableChunk(OutNameTable) || !SlotFile.ReadPlayerChunk(OutPlayerData, OutNameTable))
+		return false;
+
+	FSaveBlobPool Pool(PoolPath);
+	const FSaveBlobPool* LevelPool = Pool.Open() ? &Pool : nullptr;
+
+	for (const FSaveChunkEntry& Entry : SlotFile.GetEntries())
+	{
+		if (Entry.Type == ESaveChunkType::Level && !SlotFile.ReadLevelChunk(Entry.Key, OutLevels.Add(Entry.Key), OutNameTable, LevelPool, &OutPlaced.Add(Entry.Key)))
+			return false;
+	}
+
+	//Slots from before the slot info get one built from the player, the same way GetSaveSlotInfo reports them.
+	//The timestamp is kept otherwise, so a journal written against the slot still applies to it after an in place conversion
+	OutInfo = SlotFile.GetInfo();
+
+	if (OutInfo.FormatVersion == 0)
+	{
+		OutInfo.LevelName = OutPlayerData.CurrentLevel;
+		OutInfo.PlayerTransform = OutPlayerData.PlayerTransform;
+		OutInfo.Timestamp = IFileManager::Get().GetTimeStamp(*SlotFile.GetPath());
+	}
+
+	return true;
+}
+
+bool USaveInspectCommandlet::ConvertSlot(const FSaveInspectConfig& Config, FSaveInspectSlot& Slot)
+{
+	FSaveNameTable NameTable;
+	FPlayerSavedata PlayerData;
+	TMap<FName, FLevelSaveData> Levels;
+	TMap<FName, FSavePlacedTransforms> Placed;
+	FSaveSlotInfo SlotInfo;
+
+	if (!ReadSlotRecords(Slot.SlotName, Config.PoolPath, NameTable, PlayerData, Levels, Placed, SlotInfo))
+	{
+		UE_LOG(LogSaveInspect, Error, TEXT("%s: every record has to decode before the slot can be converted"), *Slot.SlotName);
+		return false;
+	}
+
+	const FString TargetSlotName = Config.bInPlace ? Slot.SlotName : Slot.SlotName + TEXT("_Converted");
+
+	FSaveBlobPool Pool(Config.PoolPath);
+	FSaveBlobPool* LevelPool = Config.bPool && Pool.Open() ? &Pool : nullptr;
+
+	TArray<FSaveChunkData> Chunks;
+	Chunks.Reserve(Levels.Num() + 2);
+
+	//Built the way a save builds them, the name table last so it holds every name the other chunks added
+	FSaveSlotFile::BuildPlayerChunk(PlayerData, NameTable, Chunks.AddDefaulted_GetRef(), ESaveChunkCodec::None);
+
+	for (TPair<FName, FLevelSaveData>& Pair : Levels)
+	{
+		FSaveSlotFile::BuildLevelChunk(Pair.Key, Pair.Value, NameTable, LevelPool, Chunks.AddDefaulted_GetRef(), ESaveChunkCodec::None, Placed.Find(Pair.Key));
+	}
+
+	FSaveSlotFile::BuildNameTableChunk(NameTable, Chunks.AddDefaulted_GetRef(), ESaveChunkCodec::None);
+	FSaveSlotFile::CompressChunks(Chunks, Config.Codec, true);
+
+	//No source slot, every chunk is written fresh with the current slot version
+	if ((LevelPool != nullptr && !LevelPool->Flush(Config.Codec)) || !FSaveSlotFile::WriteChunks(TargetSlotName, FString(), Chunks, SlotInfo))
+	{
+		UE_LOG(LogSaveInspect, Error, TEXT("%s: writing %s failed"), *Slot.SlotName, *TargetSlotName);
+		return false;
+	}
+
+	Slot.ConvertedSlotName = TargetSlotName;
+	Slot.ConvertedFileBytes = IFileManager::Get().FileSize(*FSaveSlotFile::GetSlotPath(TargetSlotName));
+
+	//Read back through the regular load path and checked record by record against what was read from the original
+	FSaveSlotFile Converted;
+	FSaveNameTable ConvertedNameTable;
+	FPlayerSavedata ConvertedPlayerData;
+
+	if (!Converted.Open(TargetSlotName) || !Converted.ReadNameTableChunk(ConvertedNameTable) || !Converted.ReadPlayerChunk(ConvertedPlayerData, ConvertedNameTable))
+	{
+		UE_LOG(LogSaveInspect, Error, TEXT("%s: converted slot %s does not open"), *Slot.SlotName, *TargetSlotName);
+		return false;
+	}
+
+	if (!SaveInspect::SameBytes(PlayerData.CharacterBinaryData, ConvertedPlayerData.CharacterBinaryData)
+		|| !SaveInspect::SameBytes(PlayerData.ControllerBinaryData, ConvertedPlayerData.ControllerBinaryData)
+		|| !SaveInspect::SameComponents(PlayerData.CharacterComponentsSaveData, ConvertedPlayerData.CharacterComponentsSaveData)
+		|| !SaveInspect::SameComponents(PlayerData.ControllerComponentsSaveData, ConvertedPlayerData.ControllerComponentsSaveData))
+	{
+		UE_LOG(LogSaveInspect, Error, TEXT("%s: player records differ after converting"), *Slot.SlotName);
+		return false;
+	}
+
+	for (const TPair<FName, FLevelSaveData>& Pair : Levels)
+	{
+		FSaveLevelView Original;
+		Original.Reference(Pair.Value, Placed.Find(Pair.Key));
+
+		FSaveLevelView ConvertedView;
+		FSavePlacedTransforms ConvertedPlaced;
+		FString Error;
+
+		if (!Converted.ReadLevelView(Pair.Key, ConvertedView, ConvertedNameTable, LevelPool, &ConvertedPlaced))
+			Error = TEXT("the level chunk does not decode");
+		else
+			CompareLevels(Original, ConvertedView, Error);
+
+		if (!Error.IsEmpty())
+		{
+			UE_LOG(LogSaveInspect, Error, TEXT("%s: level %s after converting, %s"), *Slot.SlotName, *Pair.Key.ToString(), *Error);
+			return false;
+		}
+	}
+
+	Slot.bConversionValid = true;
+	return true;
+}
+
+bool USaveInspectCommandlet::CompareLevels(const FSaveLevelView& Original, FSaveLevelView& Converted, FString& OutError)
+{
+	if (Original.Num() != Converted.Num())
+	{
+		OutError = FString::Printf(TEXT("%d records instead of %d"), Converted.Num(), Original.Num());
+		return false;
+	}
+
+	Converted.BuildIndex();
+
+	for (int32 i = 0; i < Original.Num(); i++)
+	{
+		const FSaveActorView& Record = Original.GetActor(i);
+		const int32* Index = Converted.GetIndex().Find(Record.ActorName);
+
+		if (Index == nullptr)
+		{
+			OutError = FString::Printf(TEXT("%s is missing"), *Record.ActorName.ToString());
+			return false;
+		}
+
+		const FSaveActorView& Other = Converted.GetActor(*Index);
+
+		if (Record.ActorClass != Other.ActorClass || !Record.Transform.Equals(Other.Transform, 0.0f) || Record.PlacedParts != Other.PlacedParts
+			|| !SaveInspect::SameBytes(Record.BinaryData, Other.BinaryData))
+		{
+			OutError = FString::Printf(TEXT("%s differs"), *Record.ActorName.ToString());
+			return false;
+		}
+
+		const TArrayView<const FSaveComponentView> Components = Original.GetComponents(Record);
+		const TArrayView<const FSaveComponentView> OtherComponents = Converted.GetComponents(Other);
+
+		bool bSameComponents = Components.Num() == OtherComponents.Num();
+
+		for (int32 c = 0; bSameComponents && c < Components.Num(); c++)
+		{
+			bSameComponents = Components[c].ComponentName == OtherComponents[c].ComponentName && SaveInspect::SameBytes(Components[c].BinaryData, OtherComponents[c].BinaryData);
+		}
+
+		if (!bSameComponents)
+		{
+			OutError = FString::Printf(TEXT("the components of %s differ"), *Record.ActorName.ToString());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void USaveInspectCommandlet::LogSlot(const FSaveInspectConfig& Config, const FSaveInspectSlot& Slot) const
+{
+	UE_LOG(LogSaveInspect, Display, TEXT("%s: version %d, %lld bytes, %d levels, %d actors, %d names, player %lld bytes"),
+		*Slot.SlotName, Slot.FormatVersion, Slot.FileBytes, Slot.Levels.Num(), Slot.Actors.Num(), Slot.NameTableEntries, Slot.PlayerBytes);
+
+	for (const FSaveInspectLevel& Level : Slot.Levels)
+	{
+		UE_LOG(LogSaveInspect, Display, TEXT("  Level %s: %d actors, %d components, %lld actor and %lld component blob bytes, chunk %lld bytes (%lld raw, %s %s)"),
+			*Level.LevelName.ToString(), Level.Actors, Level.Components, Level.ActorBlobBytes, Level.ComponentBlobBytes,
+			Level.ChunkBytes, Level.UncompressedBytes, *Level.Encoding, *Level.Codec);
+	}
+
+	TArray<FSaveInspectClass> Classes;
+	Slot.Classes.GenerateValueArray(Classes);
+
+	Classes.Sort([](const FSaveInspectClass& A, const FSaveInspectClass& B)
+		{
+			return A.Bytes > B.Bytes;
+		});
+
+	for (int32 i = 0; i < FMath::Min(Classes.Num(), Config.Top); i++)
+	{
+		const FSaveInspectClass& Class = Classes[i];
+
+		UE_LOG(LogSaveInspect, Display, TEXT("  Class %s: %d actors, %d components, %lld bytes, largest record %lld bytes"),
+			*Class.ClassName.ToString(), Class.Actors, Class.Components, Class.Bytes, Class.LargestRecordBytes);
+	}
+
+	TArray<const FSaveInspectActor*> Actors;
+	Actors.Reserve(Slot.Actors.Num());
+
+	for (const FSaveInspectActor& Actor : Slot.Actors)
+	{
+		Actors.Add(&Actor);
+	}
+
+	Actors.Sort([](const FSaveInspectActor& A, const FSaveInspectActor& B)
+		{
+			return A.ActorBytes + A.ComponentBytes > B.ActorBytes + B.ComponentBytes;
+		});
+
+	for (int32 i = 0; i < FMath::Min(Actors.Num(), Config.Top); i++)
+	{
+		const FSaveInspectActor& Actor = *Actors[i];
+
+		UE_LOG(LogSaveInspect, Display, TEXT("  Actor %s.%s (%s): %lld actor bytes, %d components with %lld bytes"),
+			*Actor.LevelName.ToString(), *Actor.ActorName.ToString(), *Actor.ClassName.ToString(), Actor.ActorBytes, Actor.Components, Actor.ComponentBytes);
+	}
+
+	if (Config.Iterations > 0 && Slot.DecodeMinSeconds > 0.0)
+	{
+		UE_LOG(LogSaveInspect, Display, TEXT("  Decode: %.3fms fastest, %.3fms average, %.1f MB/s, %.0f records/s"),
+			Slot.DecodeMinSeconds * 1000.0, Slot.DecodeAverageSeconds * 1000.0,
+			SaveInspect::ToMB(Slot.DecodedBytes) / Slot.DecodeMinSeconds, Slot.Records / Slot.DecodeMinSeconds);
+	}
+
+	if (!Slot.ConvertedSlotName.IsEmpty())
+	{
+		UE_LOG(LogSaveInspect, Display, TEXT("  Converted to %s: %lld bytes, %s"),
+			*Slot.ConvertedSlotName, Slot.ConvertedFileBytes, Slot.bConversionValid ? TEXT("every record matches") : TEXT("records differ"));
+	}
+}
+
+bool USaveInspectCommandlet::WriteResults(const FSaveInspectConfig& Config, const TArray<FSaveInspectSlot>& Slots) const
+{
+	FString SlotsCsv = TEXT("Slot,FormatVersion,FileBytes,Levels,Actors,NameTableEntries,PlayerBytes,DecodeMinMs,DecodeAverageMs,DecodedBytes,DecodeMBps,Records,RecordsPerSecond,ConvertedSlot,ConvertedFileBytes,ConversionValid\n");
+	FString LevelsCsv = TEXT("Slot,Level,Encoding,Codec,ChunkBytes,UncompressedBytes,Actors,Components,ActorBlobBytes,ComponentBlobBytes\n");
+	FString ClassesCsv = TEXT("Slot,Class,Actors,Components,Bytes,LargestRecordBytes\n");
+	FString ActorsCsv = TEXT("Slot,Level,Actor,Class,Components,ActorBytes,ComponentBytes\n");
+
+	for (const FSaveInspectSlot& Slot : Slots)
+	{
+		const double MBPerSecond = Slot.DecodeMinSeconds > 0.0 ? SaveInspect::ToMB(Slot.DecodedBytes) / Slot.DecodeMinSeconds : 0.0;
+		const double RecordsPerSecond = Slot.DecodeMinSeconds > 0.0 ? Slot.Records / Slot.DecodeMinSeconds : 0.0;
+
+		SlotsCsv += FString::Printf(TEXT("%s,%d,%lld,%d,%d,%d,%lld,%.3f,%.3f,%lld,%.1f,%d,%.0f,%s,%lld,%s\n"),
+			*Slot.SlotName, Slot.FormatVersion, Slot.FileBytes, Slot.Levels.Num(), Slot.Actors.Num(), Slot.NameTableEntries, Slot.PlayerBytes,
+			Slot.DecodeMinSeconds * 1000.0, Slot.DecodeAverageSeconds * 1000.0, Slot.DecodedBytes, MBPerSecond, Slot.Records, RecordsPerSecond,
+			*Slot.ConvertedSlotName, Slot.ConvertedFileBytes, Slot.bConversionValid ? TEXT("true") : TEXT("false"));
+
+		for (const FSaveInspectLevel& Level : Slot.Levels)
+		{
+			LevelsCsv += FString::Printf(TEXT("%s,%s,%s,%s,%lld,%lld,%d,%d,%lld,%lld\n"),
+				*Slot.SlotName, *Level.LevelName.ToString(), *Level.Encoding, *Level.Codec, Level.ChunkBytes, Level.UncompressedBytes,
+				Level.Actors, Level.Components, Level.ActorBlobBytes, Level.ComponentBlobBytes);
+		}
+
+		for (const TPair<FName, FSaveInspectClass>& Pair : Slot.Classes)
+		{
+			const FSaveInspectClass& Class = Pair.Value;
+
+			ClassesCsv += FString::Printf(TEXT("%s,%s,%d,%d,%lld,%lld\n"),
+				*Slot.SlotName, *Class.ClassName.ToString(), Class.Actors, Class.Components, Class.Bytes, Class.LargestRecordBytes);
+		}
+
+		for (const FSaveInspectActor& Actor : Slot.Actors)
+		{
+			ActorsCsv += FString::Printf(TEXT("%s,%s,%s,%s,%d,%lld,%lld\n"),
+				*Slot.SlotName, *Actor.LevelName.ToString(), *Actor.ActorName.ToString(), *Actor.ClassName.ToString(), Actor.Components, Actor.ActorBytes, Actor.ComponentBytes);
+		}
+	}
+
+	const TPair<const TCHAR*, const FString*> Files[] =
+	{
+		{ TEXT("SaveInspect_Slots.csv"), &SlotsCsv },
+		{ TEXT("SaveInspect_Levels.csv"), &LevelsCsv },
+		{ TEXT("SaveInspect_Classes.csv"), &ClassesCsv },
+		{ TEXT("SaveInspect_Actors.csv"), &ActorsCsv }
+	};
+
+	for (const TPair<const TCHAR*, const FString*>& File : Files)
+	{
+		if (!FFileHelper::SaveStringToFile(*File.Value, *(Config.OutputDir / File.Key)))
+		{
+			UE_LOG(LogSaveInspect, Error, TEXT("Failed to write %s to %s"), File.Key, *Config.OutputDir);
+			return false;
+		}
+	}
+
+	UE_LOG(LogSaveInspect, Display, TEXT("Inspection of %d slots written to %s"), Slots.Num(), *Config.OutputDir);
+	return true;
+}
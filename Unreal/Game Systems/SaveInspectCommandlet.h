@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SaveSlotFile.h"
+#include "SaveInspectCommandlet.generated.h"
+
+class FSaveLevelView;
+class FSaveNameTable;
+
+struct FSaveInspectConfig
+{
+	TArray<FString> SlotNames;
+
+	FString OutputDir;
+
+	//Decode passes timed per slot, 0 skips the benchmark
+	int32 Iterations = 5;
+
+	//Classes and actors logged per slot, the CSVs hold all of them
+	int32 Top = 10;
+
+	bool bConvert = false;
+
+	//Converted slots replace the original instead of being written next to it as <Slot>_Converted
+	bool bInPlace = false;
+
+	//Converted level chunks keep their large blobs in the blob pool
+	bool bPool = true;
+
+	//Blob pool the slots are read with and converted into, the pool of the profile unless -Pool= names another file
+	FString PoolPath;
+
+	ESaveChunkCodec Codec = ESaveChunkCodec::LZ4;
+};
+
+//One level chunk of a slot, on disk and decoded
+struct FSaveInspectLevel
+{
+	FName LevelName;
+
+	//Empty for legacy slots, their levels are not stored as chunks
+	FString Encoding;
+	FString Codec;
+
+	int64 ChunkBytes = 0;
+	int64 UncompressedBytes = 0;
+
+	int32 Actors = 0;
+	int32 Components = 0;
+
+	int64 ActorBlobBytes = 0;
+	int64 ComponentBlobBytes = 0;
+};
+
+//Every record of one actor class across the levels of a slot
+struct FSaveInspectClass
+{
+	FName ClassName;
+
+	int32 Actors = 0;
+	int32 Components = 0;
+
+	int64 Bytes = 0;
+
+	int64 LargestRecordBytes = 0;
+};
+
+struct FSaveInspectActor
+{
+	FName LevelName;
+	FName ActorName;
+	FName ClassName;
+
+	int32 Components = 0;
+
+	int64 ActorBytes = 0;
+	int64 ComponentBytes = 0;
+};
+
+struct FSaveInspectSlot
+{
+	FString SlotName;
+
+	//0 for legacy slots written before the chunked layout
+	int32 FormatVersion = 0;
+
+	int64 FileBytes = 0;
+
+	int32 NameTableEntries = 0;
+
+	//Blobs of the player character, controller and their components
+	int64 PlayerBytes = 0;
+
+	TArray<FSaveInspectLevel> Levels;
+
+	TMap<FName, FSaveInspectClass> Classes;
+
+	TArray<FSaveInspectActor> Actors;
+
+	//Decoding the whole slot, name table, player and every level, fastest and average of the timed passes
+	double DecodeMinSeconds = 0.0;
+	double DecodeAverageSeconds = 0.0;
+
+	int64 DecodedBytes = 0;
+
+	int32 Records = 0;
+
+	//Empty when the slot was not converted, otherwise the slot written and whether it read back identical
+	FString ConvertedSlotName;
+	int64 ConvertedFileBytes = 0;
+	bool bConversionValid = false;
+};
+
+/**
+ * Offline tooling for save slots: what takes up the space, how fast it decodes, and moving slots to the current format.
+ * Reports blob sizes per level, per actor class and per actor, and writes them as CSV to compare QA saves.
+ * Copy slots into Saved/SaveGames first. Run headless, also on Linux:
+ * UE4Editor-Cmd <Project>.uproject -run=SaveInspect -Slot=<Name>[+<Name>...] -nullrhi -unattended
+ * Options: -AllSlots -Out= -Iterations= -Top= -Convert -InPlace -NoPool -Pool=<Path> -Codec=None|Zlib|LZ4|Oodle
+ * -Pool= reads pooled blobs from another pool file, e.g. the one copied along with QA slots, and converts into it.
+ * -Convert rewrites the slot, legacy single object slots included, with the current slot version and chunk encoding,
+ * then reads it back and checks every record against the original.
+ */
+UCLASS()
+class SHADOWOFTHEOTHERSIDE_API USaveInspectCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	USaveInspectCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	bool InspectSlot(const FSaveInspectConfig& Config, const FString& SlotName, FSaveInspectSlot& OutSlot);
+
+	void AddLevel(FName LevelName, const FSaveLevelView& View, FSaveInspectSlot& Slot, FSaveInspectLevel& OutLevel);
+
+	void BenchmarkDecode(const FSaveInspectConfig& Config, FSaveInspectSlot& Slot);
+
+	//Reads every record of the slot, legacy slots included, into the form a save writes them from.
+	//No level is loaded here, OutPlaced keeps which transform parts the records leave at their placed transform
+	static bool ReadSlotRecords(const FString& SlotName, const FString& PoolPath, FSaveNameTable& OutNameTable, FPlayerSavedata& OutPlayerData, TMap<FName, FLevelSaveData>& OutLevels,
+		TMap<FName, FSavePlacedTransforms>& OutPlaced, FSaveSlotInfo& OutInfo);
+
+	bool ConvertSlot(const FSaveInspectConfig& Config, FSaveInspectSlot& Slot);
+
+	//Compares the records of two decoded levels, OutError names the first difference
+	static bool CompareLevels(const FSaveLevelView& Original, FSaveLevelView& Converted, FString& OutError);
+
+	void LogSlot(const FSaveInspectConfig& Config, const FSaveInspectSlot& Slot) const;
+
+	bool WriteResults(const FSaveInspectConfig& Config, const TArray<FSaveInspectSlot>& Slots) const;
+};
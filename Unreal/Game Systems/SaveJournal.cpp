@@ -0,0 +1,308 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveJournal.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Hash/CityHash.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Templates/UniquePtr.h"
+#include "SaveNameTableArchive.h"
+#include "SaveSlotFile.h"
+
+const uint32 FSaveJournal::JournalTag = 0x4C4E524A;
+const int32 FSaveJournal::JournalVersion = 1;
+
+namespace SaveJournal
+{
+	//Tag + Version + Snapshot Timestamp
+	static const int64 HeaderSize = 16;
+
+	//Size + Checksum
+	static const int64 BatchHeaderSize = 12;
+
+	static const TCHAR* Extension = TEXT(".journal");
+
+	//Journals written before every snapshot got its own file, the header still tells which snapshot it follows
+	static FString GetLegacyJournalPath(const FString& SlotName)
+	{
+		return FString::Printf(TEXT("%sSaveGames/%s%s"), *FPaths::ProjectSavedDir(), *SlotName, Extension);
+	}
+}
+
+FString FSaveJournal::GetJournalPath(const FString& InSlotName, int64 InSnapshotTicks)
+{
+	return FString::Printf(TEXT("%sSaveGames/%s.%lld%s"), *FPaths::ProjectSavedDir(), *InSlotName, InSnapshotTicks, SaveJournal::Extension);
+}
+
+bool FSaveJournal::Start(const FString& InSlotName, int64 InSnapshotTicks)
+{
+	Close();
+
+	const FString JournalPath = GetJournalPath(InSlotName, InSnapshotTicks);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(JournalPath));
+
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*JournalPath));
+
+	if (!Handle.IsValid())
+		return false;
+
+	TArray<uint8> HeaderData;
+	FMemoryWriter Writer(HeaderData);
+
+	uint32 Tag = JournalTag;
+	int32 Version = JournalVersion;
+
+	Writer << Tag;
+	Writer << Version;
+	Writer << InSnapshotTicks;
+
+	if (!Handle->Write(HeaderData.GetData(), HeaderData.Num()))
+		return false;
+
+	Path = JournalPath;
+	SlotName = InSlotName;
+	SnapshotTicks = InSnapshotTicks;
+	Size = HeaderData.Num();
+	NameCount = 0;
+
+	return true;
+}
+
+bool FSaveJournal::Resume(const FString& InSlotName, int64 InSnapshotTicks, FSaveNameTable& NameTable, TArray<FSaveJournalEntry>& OutEntries, bool bDeferClasses,
+	const TArray<uint8>* PrefetchedData)
+{
+	Close();
+	OutEntries.Reset();
+
+	FString JournalPath = GetJournalPath(InSlotName, InSnapshotTicks);
+
+	if (PrefetchedData == nullptr && !IFileManager::Get().FileExists(*JournalPath))
+		JournalPath = SaveJournal::GetLegacyJournalPath(InSlotName);
+
+	TArray<uint8> FileData;
+
+	if (PrefetchedData == nullptr && !FFileHelper::LoadFileToArray(FileData, *JournalPath, FILEREAD_Silent))
+		return false;
+
+	const TArray<uint8>& Data = PrefetchedData != nullptr ? *PrefetchedData : FileData;
+
+	if (Data.Num() < SaveJournal::HeaderSize)
+		return false;
+
+	FMemoryReader Reader(Data);
+
+	uint32 Tag = 0;
+	int32 Version = 0;
+	int64 JournalSnapshotTicks = 0;
+
+	Reader << Tag;
+	Reader << Version;
+	Reader << JournalSnapshotTicks;
+
+	//Written for an older snapshot of the slot, its changes are already part of the slot or were lost with a failed write
+	if (Tag != JournalTag || Version > JournalVersion || JournalSnapshotTicks != InSnapshotTicks)
+		return false;
+
+	int64 Offset = SaveJournal::HeaderSize;
+	int32 JournalNameCount = 0;
+
+	while (Offset + SaveJournal::BatchHeaderSize <= Data.Num())
+	{
+		Reader.Seek(Offset);
+
+		int32 BatchSize = 0;
+		uint64 Checksum = 0;
+
+		Reader << BatchSize;
+		Reader << Checksum;
+
+		const int64 BatchStart = Offset + SaveJournal::BatchHeaderSize;
+
+		//Anything from here on is the remains of an append that never finished
+		if (BatchSize < 0 || BatchStart + BatchSize > Data.Num() || CityHash64((const char*)Data.GetData() + BatchStart, BatchSize) != Checksum)
+			break;
+
+		int32 NameStart = 0;
+		TArray<FString> NewNames;
+
+		Reader << NameStart;
+		Reader << NewNames;
+
+		if (Reader.IsError() || !NameTable.AppendEntries(NameStart, NewNames))
+			break;
+
+		int32 EntryCount = 0;
+		Reader << EntryCount;
+
+		FSaveNameTableArchive Ar(Reader, NameTable);
+
+		for (int32 i = 0; i < EntryCount && !Ar.IsError(); i++)
+		{
+			SerializeEntry(Ar, OutEntries.AddDefaulted_GetRef(), bDeferClasses);
+		}
+
+		if (Ar.IsError())
+		{
+			OutEntries.SetNum(OutEntries.Num() - EntryCount);
+			break;
+		}
+
+		JournalNameCount = NameStart + NewNames.Num();
+		Offset = BatchStart + BatchSize;
+	}
+
+	Path = JournalPath;
+	SlotName = InSlotName;
+	SnapshotTicks = InSnapshotTicks;
+	Size = Offset;
+	NameCount = JournalNameCount;
+
+	return true;
+}
+
+void FSaveJournal::DeleteOtherJournals(const FString& InSlotName, int64 InSnapshotTicks)
+{
+	const FString Directory = FPaths::GetPath(GetJournalPath(InSlotName, InSnapshotTicks));
+	const FString Prefix = InSlotName + TEXT(".");
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(Directory, Prefix + TEXT("*") + SaveJournal::Extension), true, false);
+
+	for (const FString& FileName : FileNames)
+	{
+		//Only <Slot>.<Ticks>.journal, a slot whose name continues after a dot is a different slot
+		const FString Ticks = FileName.Mid(Prefix.Len(), FileName.Len() - Prefix.Len() - FCString::Strlen(SaveJournal::Extension));
+
+		if (Ticks.IsEmpty() || !Ticks.IsNumeric() || FCString::Atoi64(*Ticks) == InSnapshotTicks)
+			continue;
+
+		IFileManager::Get().Delete(*FPaths::Combine(Directory, FileName), false, true, true);
+	}
+
+	IFileManager::Get().Delete(*SaveJournal::GetLegacyJournalPath(InSlotName), false, true, true);
+}
+
+void FSaveJournal::Close()
+{
+	Path.Empty();
+	SlotName.Empty();
+
+	SnapshotTicks = 0;
+	Size = 0;
+	NameCount = 0;
+}
+
+void FSaveJournal::EncodeBatch(TArray<FSaveJournalEntry>& Entries, FSaveNameTable& NameTable, TArray<uint8>& OutBatch, int64& OutOffset)
+{
+	//Entries first, writing them can add names the batch has to carry
+	TArray<uint8> EntryData;
+	FMemoryWriter EntryWriter(EntryData);
+
+	{
+		FSaveNameTableArchive Ar(EntryWriter, NameTable);
+
+		for (FSaveJournalEntry& Entry : Entries)
+		{
+			SerializeEntry(Ar, Entry);
+		}
+	}
+
+	TArray<FString> NewNames;
+	NameTable.GetEntries(NameCount, NewNames);
+
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+
+	int32 NameStart = NameCount;
+	int32 EntryCount = Entries.Num();
+
+	PayloadWriter << NameStart;
+	PayloadWriter << NewNames;
+	PayloadWriter << EntryCount;
+	PayloadWriter.Serialize(EntryData.GetData(), EntryData.Num());
+
+	OutBatch.Reset();
+	FMemoryWriter BatchWriter(OutBatch);
+
+	int32 BatchSize = Payload.Num();
+	uint64 Checksum = CityHash64((const char*)Payload.GetData(), Payload.Num());
+
+	BatchWriter << BatchSize;
+	BatchWriter << Checksum;
+	BatchWriter.Serialize(Payload.GetData(), Payload.Num());
+
+	OutOffset = Size;
+
+	Size += OutBatch.Num();
+	NameCount = NameStart + NewNames.Num();
+}
+
+bool FSaveJournal::AppendBatch(const FString& JournalPath, int64 Offset, const TArray<uint8>& Batch)
+{
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*JournalPath, true, true));
+
+	//Seek instead of appending at the end, so a damaged tail is overwritten
+	if (!Handle.IsValid() || !Handle->Seek(Offset) || !Handle->Write(Batch.GetData(), Batch.Num()))
+		return false;
+
+	return Handle->Flush();
+}
+
+void FSaveJournal::SerializeEntry(FSaveNameTableArchive& Ar, FSaveJournalEntry& Entry, bool bDeferClasses)
+{
+	uint8 Op = (uint8)Entry.Op;
+
+	Ar << Op;
+	Ar << Entry.LevelName;
+
+	Entry.Op = (ESaveJournalOp)Op;
+
+	switch (Entry.Op)
+	{
+		case ESaveJournalOp::ActorRecord:
+		{
+			//Same record layout as a level chunk
+			FLevelSaveData LevelData;
+
+			TArray<int32> ClassPaths;
+
+			if (Ar.IsSaving())
+				LevelData.LevelActorData.Add(Entry.Record);
+
+			//Only the record class, the player data below still resolves its references
+			Ar.DeferredObjects = bDeferClasses && Ar.IsLoading() ? &ClassPaths : nullptr;
+			FSaveSlotFile::SerializeLevelChunk(Ar, LevelData, ESaveChunkEncoding::NameTableDelta);
+			Ar.DeferredObjects = nullptr;
+
+			if (Ar.IsLoading())
+			{
+				if (LevelData.LevelActorData.Num() == 1)
+					Entry.Record = MoveTemp(LevelData.LevelActorData[0]);
+				else
+					Ar.SetError();
+
+				Entry.ActorClassPath = ClassPaths.Num() == 1 ? ClassPaths[0] : INDEX_NONE;
+			}
+
+			break;
+		}
+
+		case ESaveJournalOp::ActorRemoved:
+			Ar << Entry.Record.ActorName;
+			break;
+
+		case ESaveJournalOp::Player:
+			FSaveSlotFile::SerializePlayerChunk(Ar, Entry.PlayerData);
+			break;
+
+		default:
+			Ar.SetError();
+			break;
+	}
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaveDataType.h"
+
+class FSaveNameTable;
+struct FSaveNameTableArchive;
+
+enum class ESaveJournalOp : uint8
+{
+	//Replaces or adds the record of one actor
+	ActorRecord,
+
+	//The actor was destroyed, its record is removed
+	ActorRemoved,
+
+	Player
+};
+
+//One state change written to the journal
+struct FSaveJournalEntry
+{
+	ESaveJournalOp Op = ESaveJournalOp::ActorRecord;
+
+	FName LevelName;
+
+	//Record for ActorRecord, only the actor name for ActorRemoved
+	FActorSaveData Record;
+
+	//Name table entry of the record's class when the journal was resumed with deferred classes, Record.ActorClass is null then
+	int32 ActorClassPath = INDEX_NONE;
+
+	FPlayerSavedata PlayerData;
+};
+
+/**
+ * Write ahead log of single state changes made since the slot was last written.
+ * Layout: [Tag][Version][Snapshot Timestamp] followed by [Size][Checksum][Batch] records.
+ * A batch carries the name table entries it added, so its blobs decode without a newer name table chunk.
+ * The journal only applies to the slot snapshot whose timestamp it was started with, a later write of the slot starts a new one.
+ * Every snapshot gets its own file, so the journal of the snapshot on disk survives until the write replacing it has landed.
+ */
+class SHADOWOFTHEOTHERSIDE_API FSaveJournal
+{
+public:
+
+	static const uint32 JournalTag;
+	static const int32 JournalVersion;
+
+public:
+
+	static FString GetJournalPath(const FString& SlotName, int64 SnapshotTicks);
+
+	//Starts an empty journal for the snapshot of SlotName written at SnapshotTicks, journals of other snapshots are left alone
+	bool Start(const FString& SlotName, int64 SnapshotTicks);
+
+	//Reads the journal of SlotName when it belongs to the snapshot written at SnapshotTicks and keeps appending to it.
+	//Names the batches added are appended to NameTable. A damaged tail ends the replay, later batches overwrite it.
+	//bDeferClasses keeps the record classes as name table entries in ActorClassPath, for resuming off the game thread.
+	//PrefetchedData is the journal file already read into memory, null reads it from disk
+	bool Resume(const FString& SlotName, int64 SnapshotTicks, FSaveNameTable& NameTable, TArray<FSaveJournalEntry>& OutEntries, bool bDeferClasses = false,
+		const TArray<uint8>* PrefetchedData = nullptr);
+
+	//Deletes every journal of SlotName but the one of the snapshot written at SnapshotTicks, once that snapshot is on disk.
+	//Safe to call from a worker thread
+	static void DeleteOtherJournals(const FString& SlotName, int64 SnapshotTicks);
+
+	void Close();
+
+	FORCEINLINE bool IsOpen() const { return !Path.IsEmpty(); }
+
+	FORCEINLINE const FString& GetPath() const { return Path; }
+
+	FORCEINLINE const FString& GetSlotName() const { return SlotName; }
+
+	//Timestamp of the slot snapshot the journal follows
+	FORCEINLINE int64 GetSnapshotTicks() const { return SnapshotTicks; }
+
+	//Bytes of the journal including batches that are still being appended
+	FORCEINLINE int64 GetSize() const { return Size; }
+
+	//Encodes Entries on the game thread and reserves their place in the file, OutOffset is passed to AppendBatch
+	void EncodeBatch(TArray<FSaveJournalEntry>& Entries, FSaveNameTable& NameTable, TArray<uint8>& OutBatch, int64& OutOffset);
+
+	//Writes an encoded batch, safe to call from a worker thread as long as batches are appended in order
+	static bool AppendBatch(const FString& JournalPath, int64 Offset, const TArray<uint8>& Batch);
+
+private:
+
+	static void SerializeEntry(FSaveNameTableArchive& Ar, FSaveJournalEntry& Entry, bool bDeferClasses = false);
+
+private:
+
+	FString Path;
+
+	FString SlotName;
+
+	int64 SnapshotTicks = 0;
+
+	int64 Size = 0;
+
+	//Name table entries already written by earlier batches
+	int32 NameCount = 0;
+};
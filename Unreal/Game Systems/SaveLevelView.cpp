@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveLevelView.h"
+#include "UObject/UObjectGlobals.h"
+#include "SaveNameTableArchive.h"
+
+uint8 SaveTransformParts::Compare(const FTransform& Transform, const FTransform& Base)
+{
+	uint8 Parts = 0;
+
+	Parts |= Transform.GetLocation().Equals(Base.GetLocation(), 0.0f) ? Location : 0;
+	Parts |= Transform.GetRotation().Equals(Base.GetRotation(), 0.0f) ? Rotation : 0;
+	Parts |= Transform.GetScale3D().Equals(Base.GetScale3D(), 0.0f) ? Scale : 0;
+
+	return Parts;
+}
+
+void SaveTransformParts::Copy(FTransform& Transform, const FTransform& Source, uint8 Parts)
+{
+	if (Parts & Location)
+		Transform.SetLocation(Source.GetLocation());
+
+	if (Parts & Rotation)
+		Transform.SetRotation(Source.GetRotation());
+
+	if (Parts & Scale)
+		Transform.SetScale3D(Source.GetScale3D());
+}
+
+uint8 FSavePlacedTransforms::GetPlacedParts(FName ActorName, const FTransform& Transform) const
+{
+	if (const FTransform* Placed = Transforms.Find(ActorName))
+		return SaveTransformParts::Compare(Transform, *Placed);
+
+	//The record still holds placeholders for these parts, they must not be written as values
+	const uint8* Parts = UnresolvedParts.Find(ActorName);
+	return Parts != nullptr ? *Parts : 0;
+}
+
+void FSavePlacedTransforms::ResolvePlacedParts(FName ActorName, FTransform& Transform, uint8 PlacedParts)
+{
+	if (PlacedParts == 0)
+		return;
+
+	if (const FTransform* Placed = Transforms.Find(ActorName))
+		SaveTransformParts::Copy(Transform, *Placed, PlacedParts);
+	else
+		UnresolvedParts.Add(ActorName, PlacedParts);
+}
+
+void FSaveLevelView::Reference(const FLevelSaveData& LevelData, const FSavePlacedTransforms* Placed)
+{
+	Reset();
+
+	int32 ComponentCount = 0;
+
+	for (const FActorSaveData& Record : LevelData.LevelActorData)
+	{
+		ComponentCount += Record.ComponentsSaveData.Num();
+	}
+
+	Actors.Reserve(LevelData.LevelActorData.Num());
+	Components.Reserve(ComponentCount);
+
+	for (const FActorSaveData& Record : LevelData.LevelActorData)
+	{
+		FSaveActorView& Actor = Actors.AddDefaulted_GetRef();
+		Actor.ActorClass = Record.ActorClass;
+		Actor.ActorName = Record.ActorName;
+		Actor.Transform = Record.Transform;
+		Actor.PlacedParts = Placed != nullptr ? Placed->GetPlacedParts(Record.ActorName, Record.Transform) : 0;
+		Actor.BinaryData = Record.BinaryData;
+		Actor.FirstComponent = Components.Num();
+		Actor.NumComponents = Record.ComponentsSaveData.Num();
+
+		for (const FActorComponentSaveData& Component : Record.ComponentsSaveData)
+		{
+			FSaveComponentView& ComponentView = Components.AddDefaulted_GetRef();
+			ComponentView.ComponentName = Component.ComponentName;
+			ComponentView.BinaryData = Component.BinaryData;
+		}
+	}
+}
+
+void FSaveLevelView::Materialize(FLevelSaveData& OutLevelData, FSavePlacedTransforms* Placed) const
+{
+	OutLevelData.LevelActorData.Reset(Actors.Num());
+
+	for (const FSaveActorView& Actor : Actors)
+	{
+		FActorSaveData& Record = OutLevelData.LevelActorData.AddDefaulted_GetRef();
+		Record.ActorClass = Actor.ActorClass;
+		Record.ActorName = Actor.ActorName;
+		Record.Transform = Actor.Transform;
+
+		//The level may have been loaded since the view was read, its placed transform replaces the placeholders
+		if (Placed != nullptr)
+			Placed->ResolvePlacedParts(Actor.ActorName, Record.Transform, Actor.PlacedParts);
+
+		Record.BinaryData.Append(Actor.BinaryData.GetData(), Actor.BinaryData.Num());
+
+		Record.ComponentsSaveData.SetNum(Actor.NumComponents);
+
+		for (int32 i = 0; i < Actor.NumComponents; i++)
+		{
+			const FSaveComponentView& ComponentView = Components[Actor.FirstComponent + i];
+
+			Record.ComponentsSaveData[i].ComponentName = ComponentView.ComponentName;
+			Record.ComponentsSaveData[i].BinaryData.Append(ComponentView.BinaryData.GetData(), ComponentView.BinaryData.Num());
+		}
+	}
+}
+
+void FSaveLevelView::BuildIndex()
+{
+	if (Index.Num() > 0 || Actors.Num() == 0)
+		return;
+
+	Index.Reserve(Actors.Num());
+
+	for (int32 i = 0; i < Actors.Num(); i++)
+	{
+		Index.Add(Actors[i].ActorName, i);
+	}
+}
+
+void FSaveLevelView::ResolveClasses(const FSaveNameTable& NameTable)
+{
+	check(IsInGameThread());
+
+	for (FSaveActorView& Actor : Actors)
+	{
+		UObject* ActorClass = nullptr;
+
+		if (Actor.ActorClass == nullptr && Actor.ActorClassPath != INDEX_NONE && NameTable.GetObject(Actor.ActorClassPath, ActorClass))
+			Actor.ActorClass = Cast<UClass>(ActorClass);
+	}
+}
+
+int64 FSaveLevelView::GetRecordBytes(const FSaveActorView& Actor) const
+{
+	int64 Bytes = Actor.BinaryData.Num();
+
+	for (const FSaveComponentView& Component : GetComponents(Actor))
+	{
+		Bytes += Component.BinaryData.Num();
+	}
+
+	return Bytes;
+}
+
+int64 FSaveLevelView::GetAllocatedSize() const
+{
+	return ChunkData.GetAllocatedSize() + PooledData.GetAllocatedSize() + Actors.GetAllocatedSize() + Components.GetAllocatedSize() + Index.GetAllocatedSize();
+}
+
+void FSaveLevelView::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	//Classes of levels that are not loaded would otherwise be free to go before the level streams back in
+	for (FSaveActorView& Actor : Actors)
+	{
+		Collector.AddReferencedObject(Actor.ActorClass);
+	}
+}
+
+void FSaveLevelView::Reset()
+{
+	ChunkData.Reset();
+	PooledData.Reset();
+	OwnedRecords.LevelActorData.Reset();
+	Actors.Reset();
+	Components.Reset();
+	Index.Reset();
+}
@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaveDataType.h"
+
+class FSaveNameTable;
+
+namespace SaveTransformParts
+{
+	enum : uint8
+	{
+		Location = 1 << 0,
+		Rotation = 1 << 1,
+		Scale = 1 << 2,
+
+		All = Location | Rotation | Scale
+	};
+
+	//Parts of Transform exactly equal to the same part of Base
+	uint8 Compare(const FTransform& Transform, const FTransform& Base);
+
+	//Copies Parts of Source into Transform
+	void Copy(FTransform& Transform, const FTransform& Source, uint8 Parts);
+}
+
+/**
+ * What the record transforms of one level's placed actors are written against.
+ * A placed actor that was not moved writes no transform at all, only the parts that left its placed transform.
+ */
+struct SHADOWOFTHEOTHERSIDE_API FSavePlacedTransforms
+{
+	//Placed transform of every placed save object by actor name, taken from the level while it is loaded
+	TMap<FName, FTransform> Transforms;
+
+	//Records read while their level was not loaded, the parts they leave at a placed transform that is not known yet
+	TMap<FName, uint8> UnresolvedParts;
+
+	//Parts of a record transform that are left at the actor's placed transform
+	uint8 GetPlacedParts(FName ActorName, const FTransform& Transform) const;
+
+	//Fills the placed parts of a record that was just read, or remembers them until the level is loaded
+	void ResolvePlacedParts(FName ActorName, FTransform& Transform, uint8 PlacedParts);
+};
+
+//Component record inside a FSaveLevelView, the blob points into the view's buffers
+struct FSaveComponentView
+{
+	FName ComponentName;
+
+	TArrayView<const uint8> BinaryData;
+};
+
+//Actor record inside a FSaveLevelView, the blob points into the view's buffers
+struct FSaveActorView
+{
+	//Null until FSaveLevelView::ResolveClasses for views decoded off the game thread
+	UClass* ActorClass = nullptr;
+
+	//Name table entry of ActorClass when the view was decoded with deferred classes
+	int32 ActorClassPath = INDEX_NONE;
+
+	FName ActorName;
+
+	FTransform Transform;
+
+	//Parts of Transform that are the actor's placed transform, applied from the live level instead of the record
+	uint8 PlacedParts = 0;
+
+	TArrayView<const uint8> BinaryData;
+
+	//Range of the record's components in FSaveLevelView::GetComponents
+	int32 FirstComponent = 0;
+
+	int32 NumComponents = 0;
+};
+
+/**
+ * Read only records of one level, decoded in place from the level chunk.
+ * Blobs are views into the decompressed chunk and, for pooled chunks, into one buffer holding every pooled blob of the level,
+ * so a level is decoded with a handful of allocations no matter how many records it has.
+ * Records are only copied out into a FLevelSaveData once something has to change them.
+ */
+class SHADOWOFTHEOTHERSIDE_API FSaveLevelView
+{
+public:
+
+	FSaveLevelView() = default;
+
+	//Records and components point into buffers the view owns
+	FSaveLevelView(const FSaveLevelView&) = delete;
+	FSaveLevelView& operator=(const FSaveLevelView&) = delete;
+
+	//Views the records of LevelData without copying them, LevelData has to stay unchanged while the view is used.
+	//Placed tells which transform parts of the records are left at their placed transform
+	void Reference(const FLevelSaveData& LevelData, const FSavePlacedTransforms* Placed = nullptr);
+
+	//Copies every record out, for records that are about to be changed
+	void Materialize(FLevelSaveData& OutLevelData, FSavePlacedTransforms* Placed = nullptr) const;
+
+	//Maps every actor name to its record, only built once
+	void BuildIndex();
+
+	//Loads the classes a view decoded with deferred classes left out, game thread only
+	void ResolveClasses(const FSaveNameTable& NameTable);
+
+	FORCEINLINE int32 Num() const { return Actors.Num(); }
+
+	FORCEINLINE bool IsValidIndex(int32 Index) const { return Actors.IsValidIndex(Index); }
+
+	FORCEINLINE const FSaveActorView& GetActor(int32 Index) const { return Actors[Index]; }
+
+	FORCEINLINE TArrayView<const FSaveComponentView> GetComponents(const FSaveActorView& Actor) const
+	{
+		return MakeArrayView(Components.GetData() + Actor.FirstComponent, Actor.NumComponents);
+	}
+
+	//Empty until BuildIndex ran
+	FORCEINLINE const TMap<FName, int32>& GetIndex() const { return Index; }
+
+	//Blob bytes of the actor and its components
+	int64 GetRecordBytes(const FSaveActorView& Actor) const;
+
+	//Heap the view holds
+	int64 GetAllocatedSize() const;
+
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+private:
+
+	friend class FSaveSlotFile;
+
+	void Reset();
+
+private:
+
+	//Decompressed level chunk, inline blobs point into it
+	TArray<uint8> ChunkData;
+
+	//Every pooled blob the chunk references, back to back
+	TArray<uint8> PooledData;
+
+	//Chunks written before the name table are decoded into records first, the view points into those
+	FLevelSaveData OwnedRecords;
+
+	TArray<FSaveActorView> Actors;
+
+	TArray<FSaveComponentView> Components;
+
+	TMap<FName, int32> Index;
+};
+
+//Views are decoded on a worker by LoadGameAsync and handed to the game thread
+typedef TSharedPtr<FSaveLevelView, ESPMode::ThreadSafe> FSaveLevelViewPtr;
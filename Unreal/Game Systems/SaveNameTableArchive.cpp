@@ -0,0 +1,575 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveNameTableArchive.h"
+#include "Serialization/ArchiveUObject.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/UnrealType.h"
+#include "Hash/CityHash.h"
+#include "SaveSerializationInterface.h"
+#include "SaveBlobPool.h"
+
+const uint32 FSaveNameTableArchive::BlobTag = 0x4E54424C;
+const uint32 FSaveNameTableArchive::NativeBlobTag = 0x4E54564E;
+const uint32 FSaveNameTableArchive::DeltaBlobTag = 0x4E54444C;
+const uint32 FSaveNameTableArchive::NameSignatureTag = 0x4E54534E;
+
+namespace SaveNameTableArchive
+{
+	//Tag + Signature
+	static const int32 NameSignatureSize = 12;
+}
+
+namespace SaveNameTableArchive
+{
+	//Reflection data USaveSubsystem needs per class, filled the first time an object of the class is saved or loaded
+	struct FSaveClassInfo
+	{
+		TArray<FProperty*> SaveProperties;
+
+		//Every SaveGame property is declared by the native codec class or its parents, so SerializeNative writes them all
+		bool bNativeCodecCoversSaveProperties = false;
+	};
+
+	typedef TSharedRef<const FSaveClassInfo, ESPMode::ThreadSafe> FSaveClassInfoRef;
+
+	FRWLock ClassInfoLock;
+
+	//Shared so a reader keeps its entry alive while another thread grows the map
+	TMap<TWeakObjectPtr<UClass>, FSaveClassInfoRef> ClassInfoCache;
+
+	FSaveClassInfoRef GetClassInfo(UClass* Class)
+	{
+		{
+			FReadScopeLock ReadLock(ClassInfoLock);
+
+			if (const FSaveClassInfoRef* Cached = ClassInfoCache.Find(Class))
+				return *Cached;
+		}
+
+		TSharedRef<FSaveClassInfo, ESPMode::ThreadSafe> Info = MakeShared<FSaveClassInfo, ESPMode::ThreadSafe>();
+
+		for (TFieldIterator<FProperty> It(Class); It; ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_SaveGame))
+				continue;
+
+			Info->SaveProperties.Add(*It);
+		}
+
+		//Subclasses of the codec class, native ones and Blueprints alike, may add SaveGame properties the fixed layout skips
+		const ISaveSerializationInterface* Codec = Cast<ISaveSerializationInterface>(Class->GetDefaultObject());
+		const UClass* CodecClass = Codec != nullptr && Codec->GetNativeSaveVersion() != INDEX_NONE ? Codec->GetNativeSaveClass() : nullptr;
+
+		Info->bNativeCodecCoversSaveProperties = CodecClass != nullptr && Class->IsChildOf(CodecClass);
+
+		for (FProperty* Property : Info->SaveProperties)
+		{
+			if (Info->bNativeCodecCoversSaveProperties && !CodecClass->IsChildOf(Property->GetOwnerClass()))
+			{
+				UE_LOG(LogTemp, Verbose, TEXT("%s declares SaveGame property %s outside its native codec, it is saved as tagged properties"), *Class->GetName(), *Property->GetName());
+				Info->bNativeCodecCoversSaveProperties = false;
+			}
+		}
+
+		FWriteScopeLock WriteLock(ClassInfoLock);
+		return ClassInfoCache.Add(Class, Info);
+	}
+
+	//Delta blobs leave out every property that matches the archetype, so those are put back before the delta is applied
+	void ResetToArchetype(UObject* Object)
+	{
+		UObject* Archetype = Object->GetArchetype();
+
+		if (Archetype == nullptr || !Object->IsA(Archetype->GetClass()))
+			return;
+
+		FSaveClassInfoRef ClassInfo = GetClassInfo(Object->GetClass());
+
+		for (FProperty* Property : ClassInfo->SaveProperties)
+		{
+			if (Property->GetOwnerClass() == nullptr || !Archetype->IsA(Property->GetOwnerClass()))
+				continue;
+
+			Property->CopyCompleteValue_InContainer(Object, Archetype);
+		}
+	}
+}
+
+int32 FSaveNameTable::FindOrAddName(FName Name)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+
+		if (const int32* Index = NameLookup.Find(Name))
+			return *Index;
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+
+	if (const int32* Index = NameLookup.Find(Name))
+		return *Index;
+
+	//Entries read from disk are only indexed by string until they are written as a name again
+	const FString NameString = Name.ToString();
+	const int32* LoadedIndex = PathLookup.Find(NameString);
+	const int32 Index = LoadedIndex != nullptr ? *LoadedIndex : AddEntry(NameString);
+
+	if (LoadedIndex == nullptr)
+		PathLookup.Add(NameString, Index);
+
+	NameLookup.Add(Name, Index);
+	return Index;
+}
+
+int32 FSaveNameTable::FindOrAddPath(const FString& Path)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+
+		if (const int32* Index = PathLookup.Find(Path))
+			return *Index;
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+
+	if (const int32* Index = PathLookup.Find(Path))
+		return *Index;
+
+	const int32 Index = AddEntry(Path);
+	PathLookup.Add(Path, Index);
+
+	return Index;
+}
+
+bool FSaveNameTable::GetName(int32 Index, FName& OutName) const
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	if (!Entries.IsValidIndex(Index))
+		return false;
+
+	if (ResolvedNames[Index].IsNone() && !Entries[Index].IsEmpty())
+		ResolvedNames[Index] = FName(*Entries[Index]);
+
+	OutName = ResolvedNames[Index];
+	return true;
+}
+
+bool FSaveNameTable::GetPath(int32 Index, FString& OutPath) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	if (!Entries.IsValidIndex(Index))
+		return false;
+
+	OutPath = Entries[Index];
+	return true;
+}
+
+bool FSaveNameTable::GetObject(int32 Index, UObject*& OutObject) const
+{
+	FString Path;
+
+	{
+		FReadScopeLock ReadLock(Lock);
+
+		if (!Entries.IsValidIndex(Index))
+			return false;
+
+		if (UObject* Resolved = ResolvedObjects[Index].Get())
+		{
+			OutObject = Resolved;
+			return true;
+		}
+
+		Path = Entries[Index];
+	}
+
+	//Same resolution as the string proxy archive, load the object when it is not in memory yet
+	OutObject = StaticLoadObject(UObject::StaticClass(), nullptr, *Path);
+
+	FWriteScopeLock WriteLock(Lock);
+
+	if (ResolvedObjects.IsValidIndex(Index))
+		ResolvedObjects[Index] = OutObject;
+
+	return true;
+}
+
+int32 FSaveNameTable::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Entries.Num();
+}
+
+void FSaveNameTable::GetEntries(int32 StartIndex, TArray<FString>& OutEntries) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	OutEntries.Reset();
+
+	for (int32 i = FMath::Max(StartIndex, 0); i < Entries.Num(); i++)
+	{
+		OutEntries.Add(Entries[i]);
+	}
+}
+
+bool FSaveNameTable::AppendEntries(int32 StartIndex, const TArray<FString>& NewEntries)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	if (StartIndex < 0 || StartIndex > Entries.Num())
+		return false;
+
+	for (int32 i = 0; i < NewEntries.Num(); i++)
+	{
+		const int32 Index = StartIndex + i;
+
+		if (Index < Entries.Num())
+		{
+			if (Entries[Index] != NewEntries[i])
+				return false;
+
+			continue;
+		}
+
+		PathLookup.Add(NewEntries[i], AddEntry(NewEntries[i]));
+	}
+
+	return true;
+}
+
+uint64 FSaveNameTable::GetContentHash() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return ContentHash;
+}
+
+uint64 FSaveNameTable::HashEntries(const TArray<int32>& Indices) const
+{
+	FReadScopeLock ReadLock(Lock);
+
+	uint64 Hash = Indices.Num();
+
+	for (int32 Index : Indices)
+	{
+		const FString& Entry = Entries.IsValidIndex(Index) ? Entries[Index] : FString();
+		Hash = CityHash64WithSeed((const char*)*Entry, Entry.Len() * sizeof(TCHAR), Hash);
+	}
+
+	return Hash;
+}
+
+void FSaveNameTable::Reset()
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	Entries.Reset();
+	ResolvedNames.Reset();
+	ResolvedObjects.Reset();
+	NameLookup.Reset();
+	PathLookup.Reset();
+
+	ContentHash = 0;
+}
+
+void FSaveNameTable::MoveFrom(FSaveNameTable& Other)
+{
+	if (&Other == this)
+		return;
+
+	FWriteScopeLock WriteLock(Lock);
+	FWriteScopeLock OtherWriteLock(Other.Lock);
+
+	Entries = MoveTemp(Other.Entries);
+	ResolvedNames = MoveTemp(Other.ResolvedNames);
+	ResolvedObjects = MoveTemp(Other.ResolvedObjects);
+	NameLookup = MoveTemp(Other.NameLookup);
+	PathLookup = MoveTemp(Other.PathLookup);
+
+	ContentHash = Other.ContentHash;
+	Other.ContentHash = 0;
+}
+
+int32 FSaveNameTable::AddEntry(const FString& Value)
+{
+	ContentHash = CityHash64WithSeed((const char*)*Value, Value.Len() * sizeof(TCHAR), ContentHash);
+
+	ResolvedNames.Add(NAME_None);
+	ResolvedObjects.AddDefaulted();
+	return Entries.Add(Value);
+}
+
+FArchive& operator<<(FArchive& Ar, FSaveNameTable& Table)
+{
+	if (Ar.IsLoading())
+	{
+		Table.Reset();
+
+		FWriteScopeLock WriteLock(Table.Lock);
+
+		Ar << Table.Entries;
+		Table.ResolvedNames.SetNum(Table.Entries.Num());
+		Table.ResolvedObjects.SetNum(Table.Entries.Num());
+
+		for (int32 i = 0; i < Table.Entries.Num(); i++)
+		{
+			const FString& Entry = Table.Entries[i];
+
+			Table.PathLookup.Add(Entry, i);
+			Table.ContentHash = CityHash64WithSeed((const char*)*Entry, Entry.Len() * sizeof(TCHAR), Table.ContentHash);
+		}
+
+		return Ar;
+	}
+
+	FReadScopeLock ReadLock(Table.Lock);
+	Ar << Table.Entries;
+
+	return Ar;
+}
+
+FSaveNameTableArchive::FSaveNameTableArchive(FArchive& InInnerArchive, FSaveNameTable& InNameTable)
+	: FArchiveProxy(InInnerArchive)
+	, NameTable(InNameTable)
+{
+}
+
+FArchive& FSaveNameTableArchive::operator<<(FName& Value)
+{
+	//Index + 1 so the common empty name packs into a single zero byte
+	uint32 PackedIndex = 0;
+
+	if (IsLoading())
+	{
+		InnerArchive.SerializeIntPacked(PackedIndex);
+
+		if (PackedIndex == 0 || !NameTable.GetName(PackedIndex - 1, Value))
+			Value = NAME_None;
+
+		return *this;
+	}
+
+	if (!Value.IsNone())
+		PackedIndex = NameTable.FindOrAddName(Value) + 1;
+
+	if (NameReferences != nullptr && PackedIndex != 0)
+		NameReferences->AddUnique(PackedIndex - 1);
+
+	InnerArchive.SerializeIntPacked(PackedIndex);
+	return *this;
+}
+
+FArchive& FSaveNameTableArchive::operator<<(UObject*& Value)
+{
+	uint32 PackedIndex = 0;
+
+	if (IsLoading())
+	{
+		InnerArchive.SerializeIntPacked(PackedIndex);
+
+		if (DeferredObjects != nullptr)
+		{
+			DeferredObjects->Add((int32)PackedIndex - 1);
+			Value = nullptr;
+		}
+		else if (PackedIndex == 0 || !NameTable.GetObject(PackedIndex - 1, Value))
+		{
+			Value = nullptr;
+		}
+
+		return *this;
+	}
+
+	if (Value != nullptr)
+		PackedIndex = NameTable.FindOrAddPath(Value->GetPathName()) + 1;
+
+	if (NameReferences != nullptr && PackedIndex != 0)
+		NameReferences->AddUnique(PackedIndex - 1);
+
+	InnerArchive.SerializeIntPacked(PackedIndex);
+	return *this;
+}
+
+FArchive& FSaveNameTableArchive::operator<<(FWeakObjectPtr& Value)
+{
+	return FArchiveUObject::SerializeWeakObjectPtr(*this, Value);
+}
+
+FArchive& FSaveNameTableArchive::operator<<(FSoftObjectPtr& Value)
+{
+	return FArchiveUObject::SerializeSoftObjectPtr(*this, Value);
+}
+
+FArchive& FSaveNameTableArchive::operator<<(FSoftObjectPath& Value)
+{
+	uint32 PackedIndex = 0;
+
+	if (IsLoading())
+	{
+		InnerArchive.SerializeIntPacked(PackedIndex);
+
+		FString Path;
+
+		if (PackedIndex == 0 || !NameTable.GetPath(PackedIndex - 1, Path))
+			Value.Reset();
+		else
+			Value.SetPath(Path);
+
+		return *this;
+	}
+
+	if (!Value.IsNull())
+		PackedIndex = NameTable.FindOrAddPath(Value.ToString()) + 1;
+
+	if (NameReferences != nullptr && PackedIndex != 0)
+		NameReferences->AddUnique(PackedIndex - 1);
+
+	InnerArchive.SerializeIntPacked(PackedIndex);
+	return *this;
+}
+
+FArchive& FSaveNameTableArchive::operator<<(FLazyObjectPtr& Value)
+{
+	return FArchiveUObject::SerializeLazyObjectPtr(*this, Value);
+}
+
+ISaveSerializationInterface* FSaveNameTableArchive::GetNativeCodec(UObject* Object)
+{
+	ISaveSerializationInterface* Codec = Cast<ISaveSerializationInterface>(Object);
+
+	if (Codec == nullptr || Codec->GetNativeSaveVersion() == INDEX_NONE)
+		return nullptr;
+
+	//A subclass that adds its own SaveGame variables needs the tagged path or they would be dropped
+	if (!SaveNameTableArchive::GetClassInfo(Object->GetClass())->bNativeCodecCoversSaveProperties)
+		return nullptr;
+
+	return Codec;
+}
+
+bool FSaveNameTableArchive::GetNameSignature(TArrayView<const uint8> Data, uint64& OutSignature)
+{
+	if (Data.Num() < SaveNameTableArchive::NameSignatureSize)
+		return false;
+
+	FMemoryReaderView Reader(Data);
+
+	uint32 Tag = 0;
+	Reader << Tag;
+
+	if (Tag != NameSignatureTag)
+		return false;
+
+	Reader << OutSignature;
+	return true;
+}
+
+void FSaveNameTableArchive::SaveObject(UObject* Object, TArray<uint8>& OutData, FSaveNameTable& NameTable)
+{
+	FMemoryWriter Writer(OutData);
+	TArray<int32> NameReferences;
+
+	if (ISaveSerializationInterface* Codec = GetNativeCodec(Object))
+	{
+		uint32 Tag = NativeBlobTag;
+		int32 Version = Codec->GetNativeSaveVersion();
+
+		Writer << Tag;
+		Writer << Version;
+
+		FSaveNameTableArchive Ar(Writer, NameTable);
+		Ar.ArIsSaveGame = true;
+		Ar.NameReferences = &NameReferences;
+
+		Codec->SerializeNative(Ar, Version);
+	}
+	else
+	{
+		uint32 Tag = DeltaBlobTag;
+		Writer << Tag;
+
+		//Tagged serialization already compares every property against the archetype and skips the ones that match
+		FSaveNameTableArchive Ar(Writer, NameTable);
+		Ar.ArIsSaveGame = true;
+		Ar.NameReferences = &NameReferences;
+
+		Object->Serialize(Ar);
+	}
+
+	//Blob pool keys hash the blob as a whole, with the signature in it the same blob gets the same key under every table
+	//that agrees on the names it references, instead of a new one whenever the table grows
+	if (OutData.Num() < FSaveBlobPool::MinPooledBlobBytes)
+		return;
+
+	TArray<uint8> Signature;
+	FMemoryWriter SignatureWriter(Signature);
+
+	uint32 Tag = NameSignatureTag;
+	uint64 Hash = NameTable.HashEntries(NameReferences);
+
+	SignatureWriter << Tag;
+	SignatureWriter << Hash;
+
+	OutData.Insert(Signature, 0);
+}
+
+void FSaveNameTableArchive::LoadObject(UObject* Object, TArrayView<const uint8> Data, FSaveNameTable& NameTable)
+{
+	uint64 Signature = 0;
+
+	//Only the pool needs the signature
+	if (GetNameSignature(Data, Signature))
+		Data = Data.Slice(SaveNameTableArchive::NameSignatureSize, Data.Num() - SaveNameTableArchive::NameSignatureSize);
+
+	FMemoryReaderView Reader(Data);
+
+	uint32 Tag = 0;
+
+	if (Data.Num() >= sizeof(uint32))
+		Reader << Tag;
+
+	if (Tag == NativeBlobTag)
+	{
+		int32 Version = INDEX_NONE;
+		Reader << Version;
+
+		//Only the class that wrote the layout can read it back, a class that dropped its codec keeps its defaults
+		ISaveSerializationInterface* Codec = Cast<ISaveSerializationInterface>(Object);
+
+		if (Codec == nullptr || Codec->GetNativeSaveVersion() == INDEX_NONE || Version < 0 || Version > Codec->GetNativeSaveVersion())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Save data of %s was written with native codec version %d which this build can't read"), *Object->GetName(), Version);
+			return;
+		}
+
+		FSaveNameTableArchive Ar(Reader, NameTable);
+		Ar.ArIsSaveGame = true;
+
+		Codec->SerializeNative(Ar, Version);
+		return;
+	}
+
+	if (Tag != BlobTag && Tag != DeltaBlobTag)
+	{
+		Reader.Seek(0);
+
+		FObjectAndNameAsStringProxyArchive Ar(Reader, true);
+		Ar.ArIsSaveGame = true;
+
+		Object->Serialize(Ar);
+		return;
+	}
+
+	if (Tag == DeltaBlobTag)
+		SaveNameTableArchive::ResetToArchetype(Object);
+
+	FSaveNameTableArchive Ar(Reader, NameTable);
+	Ar.ArIsSaveGame = true;
+
+	Object->Serialize(Ar);
+}
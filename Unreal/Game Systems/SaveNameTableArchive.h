@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/ArchiveProxy.h"
+#include "Misc/ScopeRWLock.h"
+
+//Append only table of every name and object path written into one save file
+class SHADOWOFTHEOTHERSIDE_API FSaveNameTable
+{
+public:
+
+	int32 FindOrAddName(FName Name);
+	int32 FindOrAddPath(const FString& Path);
+
+	bool GetName(int32 Index, FName& OutName) const;
+	bool GetPath(int32 Index, FString& OutPath) const;
+
+	//Resolves an object path entry, only the first lookup of an entry copies the path and loads the object
+	bool GetObject(int32 Index, UObject*& OutObject) const;
+
+	int32 Num() const;
+
+	//Copies the entries from StartIndex on, used to write the names a journal batch added
+	void GetEntries(int32 StartIndex, TArray<FString>& OutEntries) const;
+
+	//Adds entries read back from a journal batch. Entries the table already has must match, otherwise it returns false
+	bool AppendEntries(int32 StartIndex, const TArray<FString>& NewEntries);
+
+	//Hash over every entry in order, two tables with the same hash decode the same indices the same way
+	uint64 GetContentHash() const;
+
+	//Hash over the entries at Indices in that order, a blob referencing only those decodes the same way under any table that agrees on them
+	uint64 HashEntries(const TArray<int32>& Indices) const;
+
+	void Reset();
+
+	//Takes over the entries of Other and leaves it empty, for tables decoded on a worker
+	void MoveFrom(FSaveNameTable& Other);
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveNameTable& Table);
+
+private:
+
+	int32 AddEntry(const FString& Value);
+
+private:
+
+	TArray<FString> Entries;
+
+	//Entries converted back to names, filled lazily since most entries are paths or only read once
+	mutable TArray<FName> ResolvedNames;
+
+	//Entries resolved back to objects, weak so the table doesn't keep classes of unloaded levels alive
+	mutable TArray<TWeakObjectPtr<UObject>> ResolvedObjects;
+
+	TMap<FName, int32> NameLookup;
+
+	//Indexes every entry by its string, names are added here as well so both kinds share one entry
+	TMap<FString, int32> PathLookup;
+
+	uint64 ContentHash = 0;
+
+	mutable FRWLock Lock;
+};
+
+/**
+ * Writes names and object references as packed indices into a FSaveNameTable instead of full strings.
+ * Used in place of FObjectAndNameAsStringProxyArchive, property filtering through ArIsSaveGame works the same way.
+ */
+struct SHADOWOFTHEOTHERSIDE_API FSaveNameTableArchive : public FArchiveProxy
+{
+public:
+
+	//Tag of blobs holding every SaveGame property, blobs without any tag hold FObjectAndNameAsStringProxyArchive data
+	static const uint32 BlobTag;
+
+	//Blobs holding only the SaveGame properties that differ from the archetype, loading resets the rest to the archetype first
+	static const uint32 DeltaBlobTag;
+
+	//Blobs written through ISaveSerializationInterface::SerializeNative start with this tag followed by the codec version
+	static const uint32 NativeBlobTag;
+
+	//Put in front of the tag of blobs large enough to be pooled, followed by the hash of the name table entries the blob references
+	static const uint32 NameSignatureTag;
+
+public:
+
+	FSaveNameTableArchive(FArchive& InInnerArchive, FSaveNameTable& InNameTable);
+
+	virtual FArchive& operator<<(FName& Value) override;
+	virtual FArchive& operator<<(UObject*& Value) override;
+	virtual FArchive& operator<<(FWeakObjectPtr& Value) override;
+	virtual FArchive& operator<<(FSoftObjectPtr& Value) override;
+	virtual FArchive& operator<<(FSoftObjectPath& Value) override;
+	virtual FArchive& operator<<(FLazyObjectPtr& Value) override;
+
+	virtual FString GetArchiveName() const override { return TEXT("FSaveNameTableArchive"); }
+
+public:
+
+	//Serializes the SaveGame properties of Object into a tagged blob, through the native codec when the class has one
+	static void SaveObject(UObject* Object, TArray<uint8>& OutData, FSaveNameTable& NameTable);
+
+	//Restores a blob written by SaveObject, older blobs are still read in the format they were written in.
+	//Data is only read, it can point into a chunk buffer that holds the blobs of a whole level
+	static void LoadObject(UObject* Object, TArrayView<const uint8> Data, FSaveNameTable& NameTable);
+
+	//Returns the native codec of Object, or nullptr when its SaveGame properties have to go through Serialize
+	static class ISaveSerializationInterface* GetNativeCodec(UObject* Object);
+
+	//Reads the name signature SaveObject put in front of Data, false for blobs without one
+	static bool GetNameSignature(TArrayView<const uint8> Data, uint64& OutSignature);
+
+public:
+
+	//Set while saving to collect the name table indices written, in the order they were first written
+	TArray<int32>* NameReferences = nullptr;
+
+	//Set while loading off the game thread, object references are read as null and their name table index, INDEX_NONE for none,
+	//is appended here instead. Nothing is loaded, the game thread resolves the indices through FSaveNameTable::GetObject
+	TArray<int32>* DeferredObjects = nullptr;
+
+private:
+
+	FSaveNameTable& NameTable;
+};
@@ -0,0 +1,288 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveObjectRegistry.h"
+#include "Engine/Level.h"
+#include "Engine/Engine.h"
+#include "Components/SceneComponent.h"
+#include "SaveLoadActorInterface.h"
+#include "SaveComponentLayout.h"
+#include "SaveSubsystem.h"
+#include "SaveStats.h"
+
+namespace SaveObjectRegistry
+{
+	//Actors of a level that was just loaded may not have their components registered yet, their world transform is still identity then.
+	//The root's relative transform is what it will be placed at
+	FTransform GetPlacedTransform(const AActor* Actor)
+	{
+		const USceneComponent* Root = Actor->GetRootComponent();
+
+		if (Root == nullptr)
+			return FTransform::Identity;
+
+		return Root->IsRegistered() ? Actor->GetActorTransform() : Root->GetRelativeTransform();
+	}
+}
+
+const FName USaveObjectRegistry::SaveObjectTag = FName("SaveObject");
+
+void USaveObjectRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* World = GetWorld();
+
+	if (World == nullptr)
+		return;
+
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &USaveObjectRegistry::OnActorSpawned));
+
+	WorldInitializedActorsHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &USaveObjectRegistry::OnWorldInitializedActors);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &USaveObjectRegistry::OnLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &USaveObjectRegistry::OnLevelRemovedFromWorld);
+}
+
+void USaveObjectRegistry::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+
+	FWorldDelegates::OnWorldInitializedActors.Remove(WorldInitializedActorsHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	Entries.Reset();
+	EntryIndices.Reset();
+
+	Super::Deinitialize();
+}
+
+USaveObjectRegistry* USaveObjectRegistry::Get(const UObject* WorldContext)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull);
+	return World != nullptr ? World->GetSubsystem<USaveObjectRegistry>() : nullptr;
+}
+
+void USaveObjectRegistry::RegisterSaveObject(AActor* Actor)
+{
+	if (Actor == nullptr || Actor->IsPendingKill() || !Actor->ActorHasTag(SaveObjectTag))
+		return;
+
+	if (EntryIndices.Contains(Actor))
+		return;
+
+	FSaveObjectEntry Entry;
+	Entry.Actor = Actor;
+	Entry.Key = Actor;
+	CacheComponents(Entry);
+
+	EntryIndices.Add(Actor, Entries.Add(MoveTemp(Entry)));
+	Actor->OnDestroyed.AddUniqueDynamic(this, &USaveObjectRegistry::OnSaveObjectDestroyed);
+}
+
+void USaveObjectRegistry::UnregisterSaveObject(AActor* Actor)
+{
+	const int32* Index = EntryIndices.Find(Actor);
+
+	if (Index == nullptr)
+		return;
+
+	if (Actor != nullptr)
+		Actor->OnDestroyed.RemoveDynamic(this, &USaveObjectRegistry::OnSaveObjectDestroyed);
+
+	RemoveEntry(*Index);
+}
+
+void USaveObjectRegistry::RemoveEntry(int32 Index)
+{
+	EntryIndices.Remove(Entries[Index].Key);
+	Entries.RemoveAtSwap(Index, 1, false);
+
+	//The last entry moved into the freed slot
+	if (Entries.IsValidIndex(Index))
+		EntryIndices.Add(Entries[Index].Key, Index);
+}
+
+void USaveObjectRegistry::RefreshSaveComponents(AActor* Actor)
+{
+	const int32* Index = EntryIndices.Find(Actor);
+
+	if (Index != nullptr)
+		CacheComponents(Entries[*Index]);
+}
+
+void USaveObjectRegistry::GetSaveObjects(TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset(Entries.Num());
+
+	for (const FSaveObjectEntry& Entry : Entries)
+	{
+		AActor* Actor = Entry.Actor.Get();
+
+		if (Actor != nullptr && !Actor->IsPendingKill())
+			OutActors.Add(Actor);
+	}
+}
+
+void USaveObjectRegistry::GetSaveObjects(ULevel* Level, TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset();
+
+	for (const FSaveObjectEntry& Entry : Entries)
+	{
+		AActor* Actor = Entry.Actor.Get();
+
+		if (Actor != nullptr && !Actor->IsPendingKill() && Actor->GetLevel() == Level)
+			OutActors.Add(Actor);
+	}
+}
+
+void USaveObjectRegistry::GetSaveComponents(AActor* Actor, TArray<UActorComponent*>& OutComponents) const
+{
+	OutComponents.Reset();
+
+	const int32* Index = EntryIndices.Find(Actor);
+
+	if (Index == nullptr)
+		return;
+
+	for (const TWeakObjectPtr<UActorComponent>& Component : Entries[*Index].Components)
+	{
+		if (Component.IsValid())
+			OutComponents.Add(Component.Get());
+	}
+}
+
+void USaveObjectRegistry::RegisterLevelActors(ULevel* Level)
+{
+	if (Level == nullptr)
+		return;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor == nullptr || EntryIndices.Contains(Actor))
+			continue;
+
+		RegisterSaveObject(Actor);
+
+		//Spawned actors register as they spawn, an actor the level brings in unregistered was placed in it.
+		//Nothing has moved it yet, also when this runs before the level is initialized for play
+		const int32* Index = EntryIndices.Find(Actor);
+
+		if (Index != nullptr)
+		{
+			Entries[*Index].bPlaced = true;
+			Entries[*Index].PlacedTransform = SaveObjectRegistry::GetPlacedTransform(Actor);
+		}
+	}
+}
+
+const FTransform* USaveObjectRegistry::FindPlacedTransform(const AActor* Actor) const
+{
+	const int32* Index = EntryIndices.Find(Actor);
+
+	if (Index == nullptr || !Entries[*Index].bPlaced)
+		return nullptr;
+
+	return &Entries[*Index].PlacedTransform;
+}
+
+void USaveObjectRegistry::GetPlacedTransforms(ULevel* Level, TMap<FName, FTransform>& OutTransforms) const
+{
+	OutTransforms.Reset();
+
+	for (const FSaveObjectEntry& Entry : Entries)
+	{
+		AActor* Actor = Entry.Actor.Get();
+
+		if (Entry.bPlaced && Actor != nullptr && Actor->GetLevel() == Level)
+			OutTransforms.Add(Actor->GetFName(), Entry.PlacedTransform);
+	}
+}
+
+void USaveObjectRegistry::UnregisterLevel(ULevel* Level)
+{
+	//Streamed out actors are not destroyed, drop them here so they are not saved as missing
+	for (int32 i = Entries.Num() - 1; i >= 0; i--)
+	{
+		AActor* Actor = Entries[i].Actor.Get();
+
+		if (Actor == nullptr)
+			RemoveEntry(i);
+		else if (Level == nullptr || Actor->GetLevel() == Level)
+			UnregisterSaveObject(Actor);
+	}
+}
+
+void USaveObjectRegistry::CacheComponents(FSaveObjectEntry& Entry)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveCacheComponents);
+
+	Entry.Components.Reset();
+
+	AActor* Actor = Entry.Actor.Get();
+
+	if (Actor == nullptr)
+		return;
+
+	TArray<UActorComponent*> Components = Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass());
+
+	//Records are written in this order, so loading finds each component's record at its layout index
+	SaveComponentLayout::Sort(*SaveComponentLayout::Get(Actor, Components), Components);
+
+	Entry.Components.Reserve(Components.Num());
+
+	for (UActorComponent* Component : Components)
+	{
+		Entry.Components.Add(Component);
+	}
+}
+
+void USaveObjectRegistry::OnActorSpawned(AActor* Actor)
+{
+	RegisterSaveObject(Actor);
+}
+
+void USaveObjectRegistry::OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params)
+{
+	if (Params.World != GetWorld())
+		return;
+
+	for (ULevel* Level : Params.World->GetLevels())
+	{
+		RegisterLevelActors(Level);
+	}
+}
+
+void USaveObjectRegistry::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+		return;
+
+	RegisterLevelActors(Level);
+
+	if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(World))
+		SaveSubsystem->LoadStreamingLevel(Level);
+}
+
+void USaveObjectRegistry::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+		return;
+
+	//Captured while the actors are still registered, a null level means the whole world is going away
+	if (Level != nullptr)
+	{
+		if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(World))
+			SaveSubsystem->SaveStreamingLevel(Level);
+	}
+
+	UnregisterLevel(Level);
+}
+
+void USaveObjectRegistry::OnSaveObjectDestroyed(AActor* DestroyedActor)
+{
+	UnregisterSaveObject(DestroyedActor);
+	USaveSubsystem::MarkSaveDestroyed(DestroyedActor);
+}
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/World.h"
+#include "SaveObjectRegistry.generated.h"
+
+//One saveable actor and its ISaveLoadActorInterface components in component layout order, cached when the actor was registered
+struct FSaveObjectEntry
+{
+	TWeakObjectPtr<AActor> Actor;
+
+	//Kept separately so the entry can still be found after the actor was garbage collected
+	TObjectKey<AActor> Key;
+
+	TArray<TWeakObjectPtr<UActorComponent>> Components;
+
+	//Placed actors keep the transform they were loaded with, save records only store what moved away from it
+	bool bPlaced = false;
+
+	FTransform PlacedTransform;
+};
+
+/**
+ * Keeps a dense list of every actor tagged SaveObject in the world.
+ * Placed actors are registered once when their level is brought into play, spawned actors when they are spawned,
+ * and both are removed again when they are destroyed or their level is streamed out.
+ * Streamed sublevels are handed to the save subsystem on their way in and out, so their records follow them.
+ */
+UCLASS()
+class SHADOWOFTHEOTHERSIDE_API USaveObjectRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static const FName SaveObjectTag;
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+public:
+
+	static USaveObjectRegistry* Get(const UObject* WorldContext);
+
+	//Registers Actor if it is tagged SaveObject, for actors that get the tag after they were spawned
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void RegisterSaveObject(AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void UnregisterSaveObject(AActor* Actor);
+
+	//Recaches the save components of Actor, for components added or removed after registration
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void RefreshSaveComponents(AActor* Actor);
+
+	//Fills OutActors with every live registered actor, copied so callers may spawn or destroy while iterating
+	void GetSaveObjects(TArray<AActor*>& OutActors) const;
+
+	//Same as above for the actors of one level only
+	void GetSaveObjects(ULevel* Level, TArray<AActor*>& OutActors) const;
+
+	void GetSaveComponents(AActor* Actor, TArray<UActorComponent*>& OutComponents) const;
+
+	//Registers the SaveObject actors of Level as placed actors, safe to call again for a level that is registered already.
+	//SaveObject actors not registered yet are taken as placed, so call it as the level is loaded, before its actors are initialized or right after
+	void RegisterLevelActors(ULevel* Level);
+
+	//Transform Actor was placed with in its level, null for spawned actors
+	const FTransform* FindPlacedTransform(const AActor* Actor) const;
+
+	//Fills OutTransforms with the placed transform of every registered placed actor of Level by actor name
+	void GetPlacedTransforms(ULevel* Level, TMap<FName, FTransform>& OutTransforms) const;
+
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+private:
+
+	void UnregisterLevel(ULevel* Level);
+
+	void RemoveEntry(int32 Index);
+
+	void CacheComponents(FSaveObjectEntry& Entry);
+
+	void OnActorSpawned(AActor* Actor);
+
+	void OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params);
+
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	UFUNCTION()
+		void OnSaveObjectDestroyed(AActor* DestroyedActor);
+
+private:
+
+	TArray<FSaveObjectEntry> Entries;
+
+	TMap<TObjectKey<AActor>, int32> EntryIndices;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle WorldInitializedActorsHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
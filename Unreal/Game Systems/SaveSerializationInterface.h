@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SaveSerializationInterface.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class USaveSerializationInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Native only hints for USaveSubsystem about how an actor or save component may be serialized.
+ */
+class SHADOWOFTHEOTHERSIDE_API ISaveSerializationInterface
+{
+	GENERATED_BODY()
+
+	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
+public:
+
+	//Return true when serializing the SaveGame properties only reads this object, so it can run on a worker thread.
+	//OnActorSave is still called on the game thread before the object is serialized
+	virtual bool CanSerializeOffGameThread() const { return false; }
+
+	//Version of the fixed layout written by SerializeNative, INDEX_NONE when the SaveGame properties go through Serialize.
+	//Bump it whenever the layout changes, the version a blob was written with is passed back to SerializeNative on load
+	virtual int32 GetNativeSaveVersion() const { return INDEX_NONE; }
+
+	//Class whose SaveGame properties SerializeNative covers, those of its parents included. Override it together with SerializeNative.
+	//Objects of a subclass that declares SaveGame properties of its own, native or Blueprint, go through Serialize instead
+	virtual const UClass* GetNativeSaveClass() const { return nullptr; }
+
+	//Reads or writes the save state as a fixed binary layout instead of tagged properties, Ar.IsLoading() tells which.
+	//Only used when every SaveGame property of the object is covered, see GetNativeSaveClass
+	virtual void SerializeNative(FArchive& Ar, int32 Version) {}
+};
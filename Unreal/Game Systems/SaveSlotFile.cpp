@@ -0,0 +1,1230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveSlotFile.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/Compression.h"
+#include "Async/ParallelFor.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Templates/UniquePtr.h"
+#include "SaveNameTableArchive.h"
+#include "SaveLevelView.h"
+#include "SaveStats.h"
+
+const uint32 FSaveSlotFile::SlotTag = 0x46435352;
+const int32 FSaveSlotFile::SlotVersion = 5;
+
+const FName FSaveSlotFile::PlayerChunkKey = FName("Player");
+const FName FSaveSlotFile::NameTableChunkKey = FName("Names");
+
+namespace SaveSlotFile
+{
+	//Tag + Version + TocOffset + TocSize
+	static const int64 HeaderSize = 24;
+
+	//Level name, player transform, play time and timestamp, padded so fields can be added without moving the chunks
+	static const int64 SlotInfoSize = 232;
+
+	static const int32 LevelNameBytes = 128;
+
+	//Chunk encodings were added to the TOC in this version, older chunks all use NameAsString
+	static const int32 VersionChunkEncoding = 2;
+
+	//The slot info block follows the header from this version on
+	static const int32 VersionSlotInfo = 3;
+
+	//Slot info stores the player transform as doubles, before it used the float width of the engine that wrote it
+	static const int32 VersionSlotInfoDoubles = 4;
+
+	//Delta transforms of placed actors leave out the parts at their placed transform, older builds would read those as the identity.
+	//Nothing changes for reading, the version only keeps those builds from opening the slot
+	static const int32 VersionPlacedTransforms = 5;
+
+	//Oodle is looked up by name, engines without the plugin don't declare it
+	static const FName OodleFormat = FName("Oodle");
+
+	//Reads chunks from before the name table without loading their classes, the class paths are added to the name table instead
+	struct FDeferredClassArchive : public FObjectAndNameAsStringProxyArchive
+	{
+		FDeferredClassArchive(FArchive& InInnerArchive, FSaveNameTable& InNameTable, TArray<int32>& InClassPaths)
+			: FObjectAndNameAsStringProxyArchive(InInnerArchive, false)
+			, NameTable(InNameTable)
+			, ClassPaths(InClassPaths)
+		{
+		}
+
+		virtual FArchive& operator<<(UObject*& Value) override
+		{
+			FString Path;
+			InnerArchive << Path;
+
+			ClassPaths.Add(Path.IsEmpty() ? INDEX_NONE : NameTable.FindOrAddPath(Path));
+			Value = nullptr;
+
+			return *this;
+		}
+
+		FSaveNameTable& NameTable;
+		TArray<int32>& ClassPaths;
+	};
+
+	static FName GetCompressionFormat(ESaveChunkCodec Codec)
+	{
+		switch (Codec)
+		{
+			case ESaveChunkCodec::LZ4:
+				return NAME_LZ4;
+
+			case ESaveChunkCodec::Oodle:
+				return OodleFormat;
+
+			default:
+				return NAME_Zlib;
+		}
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FSaveSlotHeader& Header)
+{
+	Ar << Header.Tag;
+	Ar << Header.Version;
+	Ar << Header.TocOffset;
+	Ar << Header.TocSize;
+
+	return Ar;
+}
+
+void FSaveChunkEntry::Serialize(FArchive& Ar, int32 Version)
+{
+	uint8 SerializedType = (uint8)Type;
+	uint8 SerializedCodec = (uint8)Codec;
+	uint8 SerializedEncoding = (uint8)Encoding;
+	FString SerializedKey = Key.ToString();
+
+	Ar << SerializedType;
+	Ar << SerializedKey;
+	Ar << SerializedCodec;
+
+	if (Version >= SaveSlotFile::VersionChunkEncoding)
+		Ar << SerializedEncoding;
+
+	Ar << Offset;
+	Ar << Size;
+	Ar << UncompressedSize;
+
+	if (Ar.IsLoading())
+	{
+		Type = (ESaveChunkType)SerializedType;
+		Codec = (ESaveChunkCodec)SerializedCodec;
+		Encoding = Version >= SaveSlotFile::VersionChunkEncoding ? (ESaveChunkEncoding)SerializedEncoding : ESaveChunkEncoding::NameAsString;
+		Key = FName(*SerializedKey);
+	}
+}
+
+FString FSaveSlotFile::GetSlotPath(const FString& SlotName)
+{
+	return FString::Printf(TEXT("%sSaveGames/%s.sav"), *FPaths::ProjectSavedDir(), *SlotName);
+}
+
+bool FSaveSlotFile::Exists(const FString& SlotName)
+{
+	return IFileManager::Get().FileExists(*GetSlotPath(SlotName));
+}
+
+void FSaveSlotFile::FindSlotNames(TArray<FString>& OutSlotNames)
+{
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *(FPaths::ProjectSavedDir() / TEXT("SaveGames") / TEXT("*.sav")), true, false);
+
+	OutSlotNames.Reset(FileNames.Num());
+
+	for (const FString& FileName : FileNames)
+	{
+		OutSlotNames.Add(FPaths::GetBaseFilename(FileName));
+	}
+}
+
+bool FSaveSlotFile::ReadSlotInfo(const FString& SlotName, FSaveSlotInfo& OutInfo)
+{
+	const FString SlotPath = GetSlotPath(SlotName);
+	const int64 InfoHeaderSize = SaveSlotFile::HeaderSize + SaveSlotFile::SlotInfoSize;
+
+	TArray<uint8> HeaderData;
+
+	{
+		TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*SlotPath));
+
+		if (!Handle.IsValid() || Handle->Size() < SaveSlotFile::HeaderSize)
+			return false;
+
+		HeaderData.SetNumUninitialized((int32)FMath::Min(Handle->Size(), InfoHeaderSize));
+
+		if (!Handle->Read(HeaderData.GetData(), HeaderData.Num()))
+			return false;
+	}
+
+	FMemoryReader Reader(HeaderData);
+
+	FSaveSlotHeader SlotHeader;
+	Reader << SlotHeader;
+
+	if (SlotHeader.Tag != SlotTag || SlotHeader.Version > SlotVersion)
+		return false;
+
+	OutInfo = FSaveSlotInfo();
+
+	if (SlotHeader.Version >= SaveSlotFile::VersionSlotInfo)
+	{
+		if (HeaderData.Num() < InfoHeaderSize)
+			return false;
+
+		SerializeSlotInfo(Reader, OutInfo, SlotHeader.Version);
+	}
+	else
+	{
+		//Older chunked slots only know the level and transform through their player chunk
+		FSaveSlotFile SlotFile;
+		FSaveNameTable NameTable;
+		FPlayerSavedata PlayerData;
+
+		if (!SlotFile.Open(SlotName) || !SlotFile.ReadNameTableChunk(NameTable) || !SlotFile.ReadPlayerChunk(PlayerData, NameTable))
+			return false;
+
+		OutInfo.LevelName = PlayerData.CurrentLevel;
+		OutInfo.PlayerTransform = PlayerData.PlayerTransform;
+		OutInfo.Timestamp = IFileManager::Get().GetTimeStamp(*SlotPath);
+	}
+
+	OutInfo.SlotName = SlotName;
+	OutInfo.FormatVersion = SlotHeader.Version;
+
+	return !Reader.IsError();
+}
+
+bool FSaveSlotFile::Open(const FString& SlotName)
+{
+	Path.Empty();
+	Entries.Reset();
+	Bytes.Reset();
+
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*GetSlotPath(SlotName)));
+
+	if (!Handle.IsValid())
+		return false;
+
+	FileSize = Handle->Size();
+
+	return ReadHeaderAndToc(SlotName, Handle.Get());
+}
+
+bool FSaveSlotFile::Open(const FString& SlotName, FSaveSlotBytesPtr SlotBytes)
+{
+	Path.Empty();
+	Entries.Reset();
+	Bytes = SlotBytes;
+
+	if (!Bytes.IsValid())
+		return false;
+
+	FileSize = Bytes->Num();
+
+	if (ReadHeaderAndToc(SlotName, nullptr))
+		return true;
+
+	Bytes.Reset();
+	return false;
+}
+
+bool FSaveSlotFile::ReadBytes(IFileHandle* Handle, int64 Offset, uint8* OutData, int64 Size) const
+{
+	if (Handle != nullptr)
+		return Handle->Seek(Offset) && Handle->Read(OutData, Size);
+
+	if (!Bytes.IsValid() || Offset < 0 || Size < 0 || Offset + Size > Bytes->Num())
+		return false;
+
+	FMemory::Memcpy(OutData, Bytes->GetData() + Offset, Size);
+	return true;
+}
+
+bool FSaveSlotFile::ReadHeaderAndToc(const FString& SlotName, IFileHandle* Handle)
+{
+	if (FileSize < SaveSlotFile::HeaderSize)
+		return false;
+
+	TArray<uint8> HeaderData;
+	HeaderData.SetNumUninitialized((int32)FMath::Min(FileSize, SaveSlotFile::HeaderSize + SaveSlotFile::SlotInfoSize));
+
+	if (!ReadBytes(Handle, 0, HeaderData.GetData(), HeaderData.Num()))
+		return false;
+
+	FMemoryReader HeaderReader(HeaderData);
+	HeaderReader << Header;
+
+	//Anything else is a legacy single object slot
+	if (Header.Tag != SlotTag || Header.Version > SlotVersion)
+		return false;
+
+	const int64 HeaderSize = GetHeaderSize(Header.Version);
+	Info = FSaveSlotInfo();
+
+	if (HeaderData.Num() < HeaderSize)
+		return false;
+
+	if (Header.Version >= SaveSlotFile::VersionSlotInfo)
+	{
+		SerializeSlotInfo(HeaderReader, Info, Header.Version);
+		Info.SlotName = SlotName;
+		Info.FormatVersion = Header.Version;
+	}
+
+	if (Header.TocOffset < HeaderSize || Header.TocSize <= 0 || Header.TocSize > MAX_int32
+		|| Header.TocOffset + Header.TocSize > FileSize)
+		return false;
+
+	TArray<uint8> TocData;
+	TocData.SetNumUninitialized((int32)Header.TocSize);
+
+	if (!ReadBytes(Handle, Header.TocOffset, TocData.GetData(), TocData.Num()))
+		return false;
+
+	FMemoryReader TocReader(TocData);
+
+	int32 Count = 0;
+	TocReader << Count;
+
+	if (Count < 0)
+		return false;
+
+	Entries.SetNum(Count);
+
+	for (FSaveChunkEntry& Entry : Entries)
+	{
+		Entry.Serialize(TocReader, Header.Version);
+
+		if (Entry.Offset < HeaderSize || Entry.Size < 0 || Entry.Size > MAX_int32 || Entry.Offset + Entry.Size > FileSize)
+			TocReader.SetError();
+	}
+
+	if (TocReader.IsError())
+	{
+		Entries.Reset();
+		return false;
+	}
+
+	Path = GetSlotPath(SlotName);
+	return true;
+}
+
+const FSaveChunkEntry* FSaveSlotFile::FindChunk(ESaveChunkType Type, FName Key) const
+{
+	return Entries.FindByPredicate([&](const FSaveChunkEntry& Entry)
+		{
+			return Entry.Type == Type && Entry.Key == Key;
+		});
+}
+
+bool FSaveSlotFile::ReadChunk(const FSaveChunkEntry& Entry, TArray<uint8>& OutData) const
+{
+	//In memory chunks are decompressed straight out of the slot bytes
+	if (Bytes.IsValid())
+	{
+		if (!IsOpen() || Entry.Offset < 0 || Entry.Offset + Entry.Size > Bytes->Num())
+			return false;
+
+		return DecompressChunk(Entry, MakeArrayView(Bytes->GetData() + Entry.Offset, (int32)Entry.Size), OutData);
+	}
+
+	TArray<uint8> RawData;
+
+	if (!ReadRawChunk(Entry, RawData))
+		return false;
+
+	return DecompressChunk(Entry, RawData, OutData);
+}
+
+bool FSaveSlotFile::ReadRawChunk(const FSaveChunkEntry& Entry, TArray<uint8>& OutData) const
+{
+	if (!IsOpen())
+		return false;
+
+	TUniquePtr<IFileHandle> Handle;
+
+	if (!Bytes.IsValid())
+	{
+		Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+
+		if (!Handle.IsValid())
+			return false;
+	}
+
+	OutData.SetNumUninitialized((int32)Entry.Size);
+	return ReadBytes(Handle.Get(), Entry.Offset, OutData.GetData(), OutData.Num());
+}
+
+ESaveChunkCodec FSaveSlotFile::GetAvailableCodec(ESaveChunkCodec Codec)
+{
+	if (Codec == ESaveChunkCodec::None || Codec == ESaveChunkCodec::Zlib)
+		return Codec;
+
+	//Oodle ships as a plugin and LZ4 can be compiled out, slots written without them still have to load in this build
+	return FCompression::IsFormatValid(SaveSlotFile::GetCompressionFormat(Codec)) ? Codec : ESaveChunkCodec::Zlib;
+}
+
+void FSaveSlotFile::CompressChunk(ESaveChunkType Type, FName Key, const TArray<uint8>& RawData, ESaveChunkCodec Codec, FSaveChunkData& OutChunk)
+{
+	OutChunk.Type = Type;
+	OutChunk.Key = Key;
+	OutChunk.UncompressedSize = RawData.Num();
+
+	Codec = GetAvailableCodec(Codec);
+
+	if (Codec != ESaveChunkCodec::None)
+	{
+		const FName Format = SaveSlotFile::GetCompressionFormat(Codec);
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(Format, RawData.Num());
+		OutChunk.Data.SetNumUninitialized(CompressedSize);
+
+		//Keep the chunk raw when compressing does not pay off
+		if (FCompression::CompressMemory(Format, OutChunk.Data.GetData(), CompressedSize, RawData.GetData(), RawData.Num())
+			&& CompressedSize < RawData.Num())
+		{
+			OutChunk.Codec = Codec;
+			OutChunk.Data.SetNum(CompressedSize, false);
+
+			return;
+		}
+	}
+
+	OutChunk.Codec = ESaveChunkCodec::None;
+	OutChunk.Data = RawData;
+}
+
+double FSaveSlotFile::CompressChunks(TArray<FSaveChunkData>& Chunks, ESaveChunkCodec Codec, bool bParallel)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveCompressChunks);
+
+	if (Codec == ESaveChunkCodec::None)
+		return 0.0;
+
+	//Per chunk so the workers never share a counter
+	TArray<double> ChunkSeconds;
+	ChunkSeconds.SetNumZeroed(Chunks.Num());
+
+	//Chunks are independent, the largest level chunk bounds how far this scales
+	ParallelFor(Chunks.Num(), [&Chunks, &ChunkSeconds, Codec](int32 Index)
+		{
+			FSaveChunkData& Chunk = Chunks[Index];
+
+			if (Chunk.Codec != ESaveChunkCodec::None)
+				return;
+
+			const double StartTime = FPlatformTime::Seconds();
+
+			const TArray<uint8> RawData = MoveTemp(Chunk.Data);
+			CompressChunk(Chunk.Type, Chunk.Key, RawData, Codec, Chunk);
+
+			ChunkSeconds[Index] = FPlatformTime::Seconds() - StartTime;
+
+		}, !bParallel || Chunks.Num() < 2);
+
+	double TotalSeconds = 0.0;
+
+	for (double Seconds : ChunkSeconds)
+	{
+		TotalSeconds += Seconds;
+	}
+
+	return TotalSeconds;
+}
+
+bool FSaveSlotFile::DecompressChunk(const FSaveChunkEntry& Entry, TArrayView<const uint8> RawData, TArray<uint8>& OutData)
+{
+	if (Entry.Codec == ESaveChunkCodec::None)
+	{
+		OutData.Reset(RawData.Num());
+		OutData.Append(RawData.GetData(), RawData.Num());
+		return true;
+	}
+
+	if (Entry.UncompressedSize < 0 || Entry.UncompressedSize > MAX_int32)
+		return false;
+
+	OutData.SetNumUninitialized((int32)Entry.UncompressedSize);
+	return DecompressMemory(Entry.Codec, RawData, OutData.GetData(), Entry.UncompressedSize);
+}
+
+bool FSaveSlotFile::DecompressMemory(ESaveChunkCodec Codec, TArrayView<const uint8> RawData, uint8* OutData, int64 UncompressedSize)
+{
+	switch (Codec)
+	{
+		case ESaveChunkCodec::None:
+			if (RawData.Num() != UncompressedSize)
+				return false;
+
+			FMemory::Memcpy(OutData, RawData.GetData(), RawData.Num());
+			return true;
+
+		case ESaveChunkCodec::Zlib:
+		case ESaveChunkCodec::LZ4:
+		case ESaveChunkCodec::Oodle:
+		{
+			const FName Format = SaveSlotFile::GetCompressionFormat(Codec);
+
+			//Written by a build that had a codec this one lacks
+			if (!FCompression::IsFormatValid(Format) || UncompressedSize < 0 || UncompressedSize > MAX_int32)
+				return false;
+
+			return FCompression::UncompressMemory(Format, OutData, (int32)UncompressedSize, RawData.GetData(), RawData.Num());
+		}
+
+		default:
+			return false;
+	}
+}
+
+bool FSaveSlotFile::ReadNameTableChunk(FSaveNameTable& OutNameTable) const
+{
+	const FSaveChunkEntry* Entry = FindChunk(ESaveChunkType::NameTable, NameTableChunkKey);
+	TArray<uint8> Data;
+
+	//Slots written before the name table only hold string encoded chunks
+	if (Entry == nullptr)
+	{
+		OutNameTable.Reset();
+		return true;
+	}
+
+	if (!ReadChunk(*Entry, Data))
+		return false;
+
+	FMemoryReader Reader(Data);
+	Reader << OutNameTable;
+
+	return !Reader.IsError();
+}
+
+bool FSaveSlotFile::ReadPlayerChunk(FPlayerSavedata& OutPlayerData, FSaveNameTable& NameTable) const
+{
+	const FSaveChunkEntry* Entry = FindChunk(ESaveChunkType::Player, PlayerChunkKey);
+	TArray<uint8> Data;
+
+	if (Entry == nullptr || !ReadChunk(*Entry, Data))
+		return false;
+
+	FMemoryReader Reader(Data);
+
+	if (Entry->Encoding == ESaveChunkEncoding::NameAsString)
+	{
+		FObjectAndNameAsStringProxyArchive Ar(Reader, true);
+		SerializePlayerChunk(Ar, OutPlayerData);
+
+		return !Ar.IsError();
+	}
+
+	FSaveNameTableArchive Ar(Reader, NameTable);
+	SerializePlayerChunk(Ar, OutPlayerData);
+
+	return !Ar.IsError();
+}
+
+bool FSaveSlotFile::ReadLevelChunk(FName LevelName, FLevelSaveData& OutLevelData, FSaveNameTable& NameTable, const FSaveBlobPool* BlobPool, FSavePlacedTransforms* Placed,
+	TArray<int32>* OutClassPaths) const
+{
+	const FSaveChunkEntry* Entry = FindChunk(ESaveChunkType::Level, LevelName);
+	TArray<uint8> Data;
+
+	if (Entry == nullptr || !ReadChunk(*Entry, Data))
+		return false;
+
+	FMemoryReader Reader(Data);
+
+	if (OutClassPaths != nullptr)
+		OutClassPaths->Reset();
+
+	if (Entry->Encoding == ESaveChunkEncoding::NameAsString && OutClassPaths != nullptr)
+	{
+		SaveSlotFile::FDeferredClassArchive Ar(Reader, NameTable, *OutClassPaths);
+		SerializeLevelChunk(Ar, OutLevelData, Entry->Encoding);
+
+		return !Ar.IsError();
+	}
+
+	if (Entry->Encoding == ESaveChunkEncoding::NameAsString)
+	{
+		FObjectAndNameAsStringProxyArchive Ar(Reader, true);
+		SerializeLevelChunk(Ar, OutLevelData, Entry->Encoding);
+
+		return !Ar.IsError();
+	}
+
+	if (Entry->Encoding == ESaveChunkEncoding::NameTablePooled)
+	{
+		FSaveChunkBlobs Blobs;
+		Reader << Blobs.Keys;
+
+		if (Reader.IsError() || BlobPool == nullptr || !BlobPool->ReadBlobs(Blobs.Keys, Blobs.Data))
+			return false;
+
+		FSaveNameTableArchive Ar(Reader, NameTable);
+		Ar.DeferredObjects = OutClassPaths;
+		SerializeLevelChunk(Ar, OutLevelData, Entry->Encoding, &Blobs, Placed);
+
+		return !Ar.IsError();
+	}
+
+	FSaveNameTableArchive Ar(Reader, NameTable);
+	Ar.DeferredObjects = OutClassPaths;
+	SerializeLevelChunk(Ar, OutLevelData, Entry->Encoding, nullptr, Placed);
+
+	return !Ar.IsError();
+}
+
+bool FSaveSlotFile::ReadLevelView(FName LevelName, FSaveLevelView& OutView, FSaveNameTable& NameTable, const FSaveBlobPool* BlobPool, FSavePlacedTransforms* Placed,
+	bool bDeferClasses) const
+{
+	const FSaveChunkEntry* Entry = FindChunk(ESaveChunkType::Level, LevelName);
+
+	if (Entry == nullptr)
+		return false;
+
+	//Chunks from before the name table store every name as a string, they are decoded into records and viewed from there
+	if (Entry->Encoding == ESaveChunkEncoding::NameAsString)
+	{
+		FLevelSaveData LevelData;
+		TArray<int32> ClassPaths;
+
+		if (!ReadLevelChunk(LevelName, LevelData, NameTable, BlobPool, Placed, bDeferClasses ? &ClassPaths : nullptr))
+			return false;
+
+		//Moving the array keeps every record where the view points
+		OutView.Reference(LevelData, Placed);
+		OutView.OwnedRecords = MoveTemp(LevelData);
+
+		for (int32 i = 0; i < ClassPaths.Num() && i < OutView.Actors.Num(); i++)
+		{
+			OutView.Actors[i].ActorClassPath = ClassPaths[i];
+		}
+
+		return true;
+	}
+
+	OutView.Reset();
+
+	if (!ReadChunk(*Entry, OutView.ChunkData))
+		return false;
+
+	FMemoryReader Reader(OutView.ChunkData);
+
+	const bool bPooled = Entry->Encoding == ESaveChunkEncoding::NameTablePooled;
+	TArray<int64> PooledOffsets;
+
+	if (bPooled)
+	{
+		TArray<FSaveBlobKey> Keys;
+		Reader << Keys;
+
+		if (Reader.IsError() || BlobPool == nullptr || !BlobPool->ReadBlobs(Keys, OutView.PooledData, PooledOffsets))
+			return false;
+	}
+
+	//The record class is the only object reference outside the blobs, one deferred index per record
+	TArray<int32> ClassPaths;
+
+	FSaveNameTableArchive Ar(Reader, NameTable);
+	Ar.DeferredObjects = bDeferClasses ? &ClassPaths : nullptr;
+	SerializeLevelView(Ar, OutView, Entry->Encoding, bPooled ? &PooledOffsets : nullptr, Placed);
+
+	if (Ar.IsError() || (bDeferClasses && ClassPaths.Num() != OutView.Actors.Num()))
+		return false;
+
+	for (int32 i = 0; i < ClassPaths.Num(); i++)
+	{
+		OutView.Actors[i].ActorClassPath = ClassPaths[i];
+	}
+
+	return true;
+}
+
+bool FSaveSlotFile::ReadPooledBlobKeys(const FSaveChunkEntry& Entry, TArray<FSaveBlobKey>& OutKeys) const
+{
+	TArray<uint8> Data;
+
+	if (Entry.Encoding != ESaveChunkEncoding::NameTablePooled || !ReadChunk(Entry, Data))
+		return false;
+
+	FMemoryReader Reader(Data);
+	Reader << OutKeys;
+
+	return !Reader.IsError();
+}
+
+void FSaveSlotFile::BuildNameTableChunk(FSaveNameTable& NameTable, FSaveChunkData& OutChunk, ESaveChunkCodec Codec)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveBuildChunks);
+
+	TArray<uint8> RawData;
+	FMemoryWriter Writer(RawData);
+
+	Writer << NameTable;
+
+	CompressChunk(ESaveChunkType::NameTable, NameTableChunkKey, RawData, Codec, OutChunk);
+	OutChunk.Encoding = ESaveChunkEncoding::NameAsString;
+}
+
+void FSaveSlotFile::BuildPlayerChunk(FPlayerSavedata& PlayerData, FSaveNameTable& NameTable, FSaveChunkData& OutChunk, ESaveChunkCodec Codec)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveBuildChunks);
+
+	TArray<uint8> RawData;
+	FMemoryWriter Writer(RawData);
+	FSaveNameTableArchive Ar(Writer, NameTable);
+
+	SerializePlayerChunk(Ar, PlayerData);
+
+	CompressChunk(ESaveChunkType::Player, PlayerChunkKey, RawData, Codec, OutChunk);
+	OutChunk.Encoding = ESaveChunkEncoding::NameTable;
+}
+
+void FSaveSlotFile::BuildLevelChunk(FName LevelName, FLevelSaveData& LevelData, FSaveNameTable& NameTable, FSaveBlobPool* BlobPool, FSaveChunkData& OutChunk, ESaveChunkCodec Codec, FSavePlacedTransforms* Placed)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveBuildChunks);
+
+	TArray<uint8> RawData;
+	FMemoryWriter Writer(RawData);
+
+	if (BlobPool == nullptr)
+	{
+		FSaveNameTableArchive Ar(Writer, NameTable);
+		SerializeLevelChunk(Ar, LevelData, ESaveChunkEncoding::NameTableDelta, nullptr, Placed);
+
+		CompressChunk(ESaveChunkType::Level, LevelName, RawData, Codec, OutChunk);
+		OutChunk.Encoding = ESaveChunkEncoding::NameTableDelta;
+
+		return;
+	}
+
+	FSaveChunkBlobs Blobs;
+	Blobs.Pool = BlobPool;
+	Blobs.NameTableHash = NameTable.GetContentHash();
+
+	//The key list goes in front of the records but is only complete once they are written
+	TArray<uint8> RecordData;
+	FMemoryWriter RecordWriter(RecordData);
+	FSaveNameTableArchive Ar(RecordWriter, NameTable);
+
+	SerializeLevelChunk(Ar, LevelData, ESaveChunkEncoding::NameTablePooled, &Blobs, Placed);
+
+	Writer << Blobs.Keys;
+	Writer.Serialize(RecordData.GetData(), RecordData.Num());
+
+	CompressChunk(ESaveChunkType::Level, LevelName, RawData, Codec, OutChunk);
+	OutChunk.Encoding = ESaveChunkEncoding::NameTablePooled;
+}
+
+bool FSaveSlotFile::WriteChunks(const FString& SlotName, const FString& SourceSlotName, const TArray<FSaveChunkData>& Chunks, const FSaveSlotInfo& SlotInfo)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveWriteSlot);
+
+	const FString TargetPath = GetSlotPath(SlotName);
+
+	FSaveSlotFile Source;
+	const bool bHasSource = !SourceSlotName.IsEmpty() && Source.Open(SourceSlotName);
+
+	//Older versions have a smaller header, they are rewritten once to make room for the slot info
+	if (bHasSource && Source.GetPath() == TargetPath && Source.Header.Version == SlotVersion)
+	{
+		int64 LiveBytes = 0;
+
+		for (const FSaveChunkEntry& Entry : Source.Entries)
+		{
+			LiveBytes += Entry.Size;
+		}
+
+		//Compact once the chunks and TOCs left behind by previous appends outweigh the live data
+		const int64 DeadBytes = Source.FileSize - GetHeaderSize(Source.Header.Version) - Source.Header.TocSize - LiveBytes;
+
+		if (DeadBytes <= LiveBytes)
+			return AppendChunks(Source, Chunks, SlotInfo);
+	}
+
+	return RewriteSlot(TargetPath, bHasSource ? &Source : nullptr, Chunks, SlotInfo);
+}
+
+void FSaveSlotFile::SerializePlayerChunk(FArchive& Ar, FPlayerSavedata& PlayerData)
+{
+	FPlayerSavedata::StaticStruct()->SerializeItem(Ar, &PlayerData, nullptr);
+}
+
+void FSaveSlotFile::SerializeLevelChunk(FArchive& Ar, FLevelSaveData& LevelData, ESaveChunkEncoding Encoding, FSaveChunkBlobs* Blobs, FSavePlacedTransforms* Placed)
+{
+	int32 RecordCount = LevelData.LevelActorData.Num();
+	Ar << RecordCount;
+
+	if (Ar.IsLoading())
+	{
+		if (RecordCount < 0)
+		{
+			Ar.SetError();
+			return;
+		}
+
+		LevelData.LevelActorData.SetNum(RecordCount);
+	}
+
+	for (FActorSaveData& Record : LevelData.LevelActorData)
+	{
+		Ar << Record.ActorClass;
+		Ar << Record.ActorName;
+
+		if (Encoding == ESaveChunkEncoding::NameTableDelta || Encoding == ESaveChunkEncoding::NameTablePooled)
+		{
+			uint8 PlacedParts = Ar.IsSaving() && Placed != nullptr ? Placed->GetPlacedParts(Record.ActorName, Record.Transform) : 0;
+			SerializeDeltaTransform(Ar, Record.Transform, PlacedParts);
+
+			if (Ar.IsLoading() && Placed != nullptr)
+				Placed->ResolvePlacedParts(Record.ActorName, Record.Transform, PlacedParts);
+		}
+		else
+		{
+			Ar << Record.Transform;
+		}
+
+		SerializeBlob(Ar, Record.BinaryData, Blobs);
+
+		int32 ComponentCount = Record.ComponentsSaveData.Num();
+		Ar << ComponentCount;
+
+		if (Ar.IsLoading())
+		{
+			if (ComponentCount < 0 || Ar.IsError())
+			{
+				Ar.SetError();
+				return;
+			}
+
+			Record.ComponentsSaveData.SetNum(ComponentCount);
+		}
+
+		for (FActorComponentSaveData& Component : Record.ComponentsSaveData)
+		{
+			Ar << Component.ComponentName;
+			SerializeBlob(Ar, Component.BinaryData, Blobs);
+		}
+	}
+}
+
+void FSaveSlotFile::SerializeDeltaTransform(FArchive& Ar, FTransform& Transform, uint8& PlacedParts)
+{
+	enum ETransformParts : uint8
+	{
+		HasLocation = 1 << 0,
+		HasRotation = 1 << 1,
+		HasScale = 1 << 2,
+
+		//The placed parts in the next three bits, they are not written
+		PlacedShift = 3
+	};
+
+	FVector Location = Transform.GetLocation();
+	FQuat Rotation = Transform.GetRotation();
+	FVector Scale = Transform.GetScale3D();
+
+	uint8 Parts = 0;
+
+	if (Ar.IsSaving())
+	{
+		Parts |= Location.IsZero() ? 0 : HasLocation;
+		Parts |= Rotation.Equals(FQuat::Identity, 0.0f) ? 0 : HasRotation;
+		Parts |= Scale.Equals(FVector::OneVector, 0.0f) ? 0 : HasScale;
+
+		Parts = (Parts & ~PlacedParts) | (PlacedParts << PlacedShift);
+	}
+
+	Ar << Parts;
+
+	if (Ar.IsLoading())
+		PlacedParts = (Parts >> PlacedShift) & SaveTransformParts::All;
+
+	if (Parts & HasLocation)
+		Ar << Location;
+
+	if (Parts & HasRotation)
+		Ar << Rotation;
+
+	if (Parts & HasScale)
+		Ar << Scale;
+
+	if (Ar.IsLoading())
+	{
+		Transform = FTransform(Parts & HasRotation ? Rotation : FQuat::Identity, Parts & HasLocation ? Location : FVector::ZeroVector,
+			Parts & HasScale ? Scale : FVector::OneVector);
+	}
+}
+
+void FSaveSlotFile::SerializeBlob(FArchive& Ar, TArray<uint8>& Data, FSaveChunkBlobs* Blobs)
+{
+	if (Blobs == nullptr)
+	{
+		Ar << Data;
+		return;
+	}
+
+	//Index + 1 into the chunk's key list, zero for blobs stored inline
+	uint32 PackedIndex = 0;
+
+	if (Ar.IsSaving() && Blobs->Pool != nullptr && Data.Num() >= FSaveBlobPool::MinPooledBlobBytes)
+	{
+		const FSaveBlobKey Key = Blobs->Pool->Add(Data, Blobs->NameTableHash);
+		const int32* Existing = Blobs->KeyIndex.Find(Key);
+
+		PackedIndex = (Existing != nullptr ? *Existing : Blobs->KeyIndex.Add(Key, Blobs->Keys.Add(Key))) + 1;
+	}
+
+	Ar.SerializeIntPacked(PackedIndex);
+
+	if (PackedIndex == 0)
+	{
+		Ar << Data;
+		return;
+	}
+
+	if (Ar.IsLoading())
+	{
+		if (!Blobs->Data.IsValidIndex(PackedIndex - 1))
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Data = Blobs->Data[PackedIndex - 1];
+	}
+}
+
+void FSaveSlotFile::SerializeLevelView(FArchive& Ar, FSaveLevelView& View, ESaveChunkEncoding Encoding, const TArray<int64>* PooledOffsets, FSavePlacedTransforms* Placed)
+{
+	int32 RecordCount = 0;
+	Ar << RecordCount;
+
+	//Every record takes at least a few bytes of the chunk
+	if (RecordCount < 0 || RecordCount > View.ChunkData.Num())
+	{
+		Ar.SetError();
+		return;
+	}
+
+	View.Actors.SetNum(RecordCount);
+	View.Components.Reserve(RecordCount);
+
+	for (FSaveActorView& Actor : View.Actors)
+	{
+		//Written through the record's class property, which serializes as a plain object reference
+		UObject* ActorClass = nullptr;
+
+		Ar << ActorClass;
+		Ar << Actor.ActorName;
+
+		Actor.ActorClass = Cast<UClass>(ActorClass);
+
+		if (Encoding == ESaveChunkEncoding::NameTableDelta || Encoding == ESaveChunkEncoding::NameTablePooled)
+		{
+			SerializeDeltaTransform(Ar, Actor.Transform, Actor.PlacedParts);
+
+			if (Placed != nullptr)
+				Placed->ResolvePlacedParts(Actor.ActorName, Actor.Transform, Actor.PlacedParts);
+		}
+		else
+		{
+			Ar << Actor.Transform;
+		}
+
+		ReadBlobView(Ar, View, PooledOffsets, Actor.BinaryData);
+
+		int32 ComponentCount = 0;
+		Ar << ComponentCount;
+
+		if (ComponentCount < 0 || Ar.IsError())
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Actor.FirstComponent = View.Components.Num();
+		Actor.NumComponents = ComponentCount;
+
+		for (int32 i = 0; i < ComponentCount && !Ar.IsError(); i++)
+		{
+			FSaveComponentView& Component = View.Components.AddDefaulted_GetRef();
+
+			Ar << Component.ComponentName;
+			ReadBlobView(Ar, View, PooledOffsets, Component.BinaryData);
+		}
+	}
+}
+
+void FSaveSlotFile::ReadBlobView(FArchive& Ar, const FSaveLevelView& View, const TArray<int64>* PooledOffsets, TArrayView<const uint8>& OutData)
+{
+	//Same packed index SerializeBlob writes, zero for blobs stored inline
+	if (PooledOffsets != nullptr)
+	{
+		uint32 PackedIndex = 0;
+		Ar.SerializeIntPacked(PackedIndex);
+
+		if (PackedIndex != 0)
+		{
+			const int32 BlobIndex = PackedIndex - 1;
+
+			if (BlobIndex >= PooledOffsets->Num() - 1)
+			{
+				Ar.SetError();
+				return;
+			}
+
+			const int64 Start = (*PooledOffsets)[BlobIndex];
+			OutData = MakeArrayView(View.PooledData.GetData() + Start, (int32)((*PooledOffsets)[BlobIndex + 1] - Start));
+
+			return;
+		}
+	}
+
+	//Inline blobs are a byte array, the view skips over its bytes instead of copying them
+	int32 Size = 0;
+	Ar << Size;
+
+	const int64 Offset = Ar.Tell();
+
+	if (Size < 0 || Offset + Size > View.ChunkData.Num() || Ar.IsError())
+	{
+		Ar.SetError();
+		return;
+	}
+
+	OutData = MakeArrayView(View.ChunkData.GetData() + Offset, Size);
+	Ar.Seek(Offset + Size);
+}
+
+bool FSaveSlotFile::AppendChunks(const FSaveSlotFile& Existing, const TArray<FSaveChunkData>& Chunks, const FSaveSlotInfo& SlotInfo)
+{
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Existing.Path, true, true));
+
+	if (!Handle.IsValid() || !Handle->Seek(Existing.FileSize))
+		return false;
+
+	TArray<FSaveChunkEntry> NewEntries = Existing.Entries;
+	int64 Offset = Existing.FileSize;
+
+	for (const FSaveChunkData& Chunk : Chunks)
+	{
+		if (!Handle->Write(Chunk.Data.GetData(), Chunk.Data.Num()))
+			return false;
+
+		FSaveChunkEntry Entry;
+		Entry.Type = Chunk.Type;
+		Entry.Key = Chunk.Key;
+		Entry.Codec = Chunk.Codec;
+		Entry.Encoding = Chunk.Encoding;
+		Entry.Offset = Offset;
+		Entry.Size = Chunk.Data.Num();
+		Entry.UncompressedSize = Chunk.UncompressedSize;
+
+		MergeEntries(NewEntries, Entry);
+		Offset += Entry.Size;
+	}
+
+	//The old header still points at the old TOC until this succeeds, so a failed append leaves the slot readable
+	return WriteTocAndHeader(Handle.Get(), NewEntries, SlotInfo);
+}
+
+bool FSaveSlotFile::RewriteSlot(const FString& TargetPath, const FSaveSlotFile* Source, const TArray<FSaveChunkData>& Chunks, const FSaveSlotInfo& SlotInfo)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(TargetPath));
+
+	const FString TempPath = TargetPath + TEXT(".tmp");
+
+	{
+		TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*TempPath));
+
+		if (!Handle.IsValid())
+			return false;
+
+		//Placeholder until the TOC position is known
+		TArray<uint8> HeaderData;
+		HeaderData.SetNumZeroed((int32)GetHeaderSize(SlotVersion));
+
+		if (!Handle->Write(HeaderData.GetData(), HeaderData.Num()))
+			return false;
+
+		TArray<FSaveChunkEntry> NewEntries;
+		int64 Offset = HeaderData.Num();
+
+		//Carry over the chunks that are not being replaced without decoding them
+		if (Source != nullptr)
+		{
+			TArray<uint8> RawData;
+
+			for (const FSaveChunkEntry& SourceEntry : Source->Entries)
+			{
+				const bool bReplaced = Chunks.ContainsByPredicate([&](const FSaveChunkData& Chunk)
+					{
+						return Chunk.Type == SourceEntry.Type && Chunk.Key == SourceEntry.Key;
+					});
+
+				if (bReplaced)
+					continue;
+
+				if (!Source->ReadRawChunk(SourceEntry, RawData) || !Handle->Write(RawData.GetData(), RawData.Num()))
+					return false;
+
+				FSaveChunkEntry Entry = SourceEntry;
+				Entry.Offset = Offset;
+
+				NewEntries.Add(Entry);
+				Offset += Entry.Size;
+			}
+		}
+
+		for (const FSaveChunkData& Chunk : Chunks)
+		{
+			if (!Handle->Write(Chunk.Data.GetData(), Chunk.Data.Num()))
+				return false;
+
+			FSaveChunkEntry Entry;
+			Entry.Type = Chunk.Type;
+			Entry.Key = Chunk.Key;
+			Entry.Codec = Chunk.Codec;
+			Entry.Encoding = Chunk.Encoding;
+			Entry.Offset = Offset;
+			Entry.Size = Chunk.Data.Num();
+			Entry.UncompressedSize = Chunk.UncompressedSize;
+
+			MergeEntries(NewEntries, Entry);
+			Offset += Entry.Size;
+		}
+
+		if (!WriteTocAndHeader(Handle.Get(), NewEntries, SlotInfo))
+			return false;
+	}
+
+	return IFileManager::Get().Move(*TargetPath, *TempPath, true);
+}
+
+void FSaveSlotFile::MergeEntries(TArray<FSaveChunkEntry>& Entries, const FSaveChunkEntry& NewEntry)
+{
+	FSaveChunkEntry* Existing = Entries.FindByPredicate([&](const FSaveChunkEntry& Entry)
+		{
+			return Entry.Type == NewEntry.Type && Entry.Key == NewEntry.Key;
+		});
+
+	if (Existing != nullptr)
+		*Existing = NewEntry;
+	else
+		Entries.Add(NewEntry);
+}
+
+bool FSaveSlotFile::WriteTocAndHeader(IFileHandle* Handle, const TArray<FSaveChunkEntry>& Entries, const FSaveSlotInfo& SlotInfo)
+{
+	TArray<uint8> TocData;
+	FMemoryWriter TocWriter(TocData);
+
+	int32 Count = Entries.Num();
+	TocWriter << Count;
+
+	for (FSaveChunkEntry Entry : Entries)
+	{
+		Entry.Serialize(TocWriter, SlotVersion);
+	}
+
+	FSaveSlotHeader NewHeader;
+	NewHeader.Tag = SlotTag;
+	NewHeader.Version = SlotVersion;
+	NewHeader.TocOffset = Handle->Tell();
+	NewHeader.TocSize = TocData.Num();
+
+	if (!Handle->Write(TocData.GetData(), TocData.Num()) || !Handle->Flush())
+		return false;
+
+	TArray<uint8> HeaderData;
+	FMemoryWriter HeaderWriter(HeaderData);
+	HeaderWriter << NewHeader;
+
+	FSaveSlotInfo WrittenInfo = SlotInfo;
+	SerializeSlotInfo(HeaderWriter, WrittenInfo, SlotVersion);
+
+	return Handle->Seek(0) && Handle->Write(HeaderData.GetData(), HeaderData.Num()) && Handle->Flush();
+}
+
+void FSaveSlotFile::SerializeSlotInfo(FArchive& Ar, FSaveSlotInfo& SlotInfo, int32 Version)
+{
+	const int64 StartPos = Ar.Tell();
+
+	//Fixed width UTF-8, zero padded. Longer names are cut, the level name is only shown in menus
+	uint8 LevelNameData[SaveSlotFile::LevelNameBytes];
+	FMemory::Memzero(LevelNameData);
+
+	if (Ar.IsSaving())
+	{
+		FTCHARToUTF8 LevelNameUtf8(*SlotInfo.LevelName.ToString());
+		FMemory::Memcpy(LevelNameData, LevelNameUtf8.Get(), FMath::Min(LevelNameUtf8.Length(), SaveSlotFile::LevelNameBytes - 1));
+	}
+
+	Ar.Serialize(LevelNameData, SaveSlotFile::LevelNameBytes);
+
+	const FVector Location = SlotInfo.PlayerTransform.GetLocation();
+	const FQuat Rotation = SlotInfo.PlayerTransform.GetRotation();
+	const FVector Scale = SlotInfo.PlayerTransform.GetScale3D();
+
+	//Location, rotation and scale. Explicit widths, the layout must not follow the engine's vector precision
+	double Transform[10] = { Location.X, Location.Y, Location.Z, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Scale.X, Scale.Y, Scale.Z };
+
+	for (double& Value : Transform)
+	{
+		if (Version >= SaveSlotFile::VersionSlotInfoDoubles)
+		{
+			Ar << Value;
+			continue;
+		}
+
+		float FloatValue = (float)Value;
+		Ar << FloatValue;
+		Value = FloatValue;
+	}
+
+	double PlayTimeSeconds = SlotInfo.PlayTimeSeconds;
+	int64 TimestampTicks = SlotInfo.Timestamp.GetTicks();
+
+	Ar << PlayTimeSeconds;
+	Ar << TimestampTicks;
+
+	//Pad up to the fixed size, loading skips the bytes a newer writer may have used
+	const int64 Padding = StartPos + SaveSlotFile::SlotInfoSize - Ar.Tell();
+
+	if (Padding > 0)
+	{
+		TArray<uint8> PaddingData;
+		PaddingData.SetNumZeroed((int32)Padding);
+
+		Ar.Serialize(PaddingData.GetData(), PaddingData.Num());
+	}
+
+	if (Ar.IsLoading())
+	{
+		LevelNameData[SaveSlotFile::LevelNameBytes - 1] = 0;
+
+		SlotInfo.LevelName = FName(UTF8_TO_TCHAR((const ANSICHAR*)LevelNameData));
+		SlotInfo.PlayerTransform = FTransform(FQuat(Transform[3], Transform[4], Transform[5], Transform[6]),
+			FVector(Transform[0], Transform[1], Transform[2]), FVector(Transform[7], Transform[8], Transform[9]));
+		SlotInfo.PlayTimeSeconds = (float)PlayTimeSeconds;
+		SlotInfo.Timestamp = FDateTime(TimestampTicks);
+	}
+}
+
+int64 FSaveSlotFile::GetHeaderSize(int32 Version)
+{
+	return Version >= SaveSlotFile::VersionSlotInfo ? SaveSlotFile::HeaderSize + SaveSlotFile::SlotInfoSize : SaveSlotFile::HeaderSize;
+}
@@ -0,0 +1,255 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaveDataType.h"
+#include "SaveSlotInfo.h"
+#include "SaveBlobPool.h"
+#include "SaveSlotFile.generated.h"
+
+class IFileHandle;
+class FSaveNameTable;
+class FSaveLevelView;
+struct FSavePlacedTransforms;
+
+enum class ESaveChunkType : uint8
+{
+	Player,
+	Level,
+	NameTable
+};
+
+//How names and object references inside a chunk were written
+enum class ESaveChunkEncoding : uint8
+{
+	NameAsString,
+	NameTable,
+
+	//Name table, and record transforms only store the parts that differ from the identity transform,
+	//or for placed actors from their placed transform
+	NameTableDelta,
+
+	//NameTableDelta with the actor and component blobs stored in the FSaveBlobPool, the chunk starts with the keys it references
+	NameTablePooled
+};
+
+//Compression of one chunk, every chunk is compressed on its own so it can be read without the rest of the slot
+UENUM(BlueprintType)
+enum class ESaveChunkCodec : uint8
+{
+	None,
+	Zlib,
+
+	//Fastest to write and read, the default for saves made during play
+	LZ4,
+
+	//Smallest output, only when the build has the Oodle compression plugin, otherwise Zlib is used
+	Oodle
+};
+
+//Fixed size block at the start of every chunked slot, points at the table of contents
+struct FSaveSlotHeader
+{
+	uint32 Tag = 0;
+	int32 Version = 0;
+	int64 TocOffset = 0;
+	int64 TocSize = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveSlotHeader& Header);
+};
+
+//Location of one independently readable chunk inside the slot file
+struct FSaveChunkEntry
+{
+	ESaveChunkType Type = ESaveChunkType::Level;
+	FName Key;
+	ESaveChunkCodec Codec = ESaveChunkCodec::None;
+	ESaveChunkEncoding Encoding = ESaveChunkEncoding::NameAsString;
+	int64 Offset = 0;
+	int64 Size = 0;
+	int64 UncompressedSize = 0;
+
+	void Serialize(FArchive& Ar, int32 Version);
+};
+
+//A serialized and compressed chunk waiting to be written
+struct FSaveChunkData
+{
+	ESaveChunkType Type = ESaveChunkType::Level;
+	FName Key;
+	ESaveChunkCodec Codec = ESaveChunkCodec::None;
+	ESaveChunkEncoding Encoding = ESaveChunkEncoding::NameTable;
+	int64 UncompressedSize = 0;
+	TArray<uint8> Data;
+};
+
+//Pool keys of one pooled level chunk, records reference their blobs by index into Keys
+struct FSaveChunkBlobs
+{
+	//Set while building a chunk, new blobs are queued here
+	FSaveBlobPool* Pool = nullptr;
+
+	uint64 NameTableHash = 0;
+
+	TArray<FSaveBlobKey> Keys;
+
+	TMap<FSaveBlobKey, int32> KeyIndex;
+
+	//Blob of every key, read from the pool before the records are
+	TArray<TArray<uint8>> Data;
+};
+
+//A whole slot file read into memory, shared by the prefetch that read it and the loads reading chunks out of it
+typedef TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> FSaveSlotBytesPtr;
+
+/**
+ * Slot layout: [Header][Slot Info][Chunk]...[Chunk][TOC]
+ * Header and slot info have a fixed size so menus can read a slot summary with a single small read.
+ * Saving appends the rewritten chunks and a new TOC, then patches the header, so untouched levels are never rewritten.
+ * The file is compacted once dead chunks outweigh the live ones.
+ */
+class SHADOWOFTHEOTHERSIDE_API FSaveSlotFile
+{
+public:
+
+	static const uint32 SlotTag;
+	static const int32 SlotVersion;
+
+	static const FName PlayerChunkKey;
+	static const FName NameTableChunkKey;
+
+public:
+
+	static FString GetSlotPath(const FString& SlotName);
+
+	//Whether a slot file is at GetSlotPath, slots are read and written there directly and not through the platform save system
+	static bool Exists(const FString& SlotName);
+
+	//Names of every slot file in the save directory
+	static void FindSlotNames(TArray<FString>& OutSlotNames);
+
+	//Reads only the fixed size slot header. Slots from before the slot info fall back to their player chunk
+	static bool ReadSlotInfo(const FString& SlotName, FSaveSlotInfo& OutInfo);
+
+	//Reads the header and table of contents only
+	bool Open(const FString& SlotName);
+
+	//Same as above out of the slot file already in memory, chunks are then read from SlotBytes instead of the disk
+	bool Open(const FString& SlotName, FSaveSlotBytesPtr SlotBytes);
+
+	FORCEINLINE bool IsOpen() const { return !Path.IsEmpty(); }
+
+	FORCEINLINE bool IsInMemory() const { return Bytes.IsValid(); }
+
+	FORCEINLINE const FString& GetPath() const { return Path; }
+
+	FORCEINLINE const TArray<FSaveChunkEntry>& GetEntries() const { return Entries; }
+
+	//Empty for slots written before the slot info existed
+	FORCEINLINE const FSaveSlotInfo& GetInfo() const { return Info; }
+
+	const FSaveChunkEntry* FindChunk(ESaveChunkType Type, FName Key) const;
+
+	//Streams a single chunk from disk and decompresses it
+	bool ReadChunk(const FSaveChunkEntry& Entry, TArray<uint8>& OutData) const;
+
+	//Streams a single chunk from disk without decoding it
+	bool ReadRawChunk(const FSaveChunkEntry& Entry, TArray<uint8>& OutData) const;
+
+	//The name table has to be read before any chunk that references it
+	bool ReadNameTableChunk(FSaveNameTable& OutNameTable) const;
+
+	bool ReadPlayerChunk(FPlayerSavedata& OutPlayerData, FSaveNameTable& NameTable) const;
+	//BlobPool resolves the blobs of pooled chunks, without it only unpooled chunks can be read.
+	//Placed fills the transform parts placed actors left at their placed transform, without it those parts are the identity
+	//With OutClassPaths the record classes are not loaded, they stay null and OutClassPaths gets the name table entry of each record's class
+	//in record order. Only that way a chunk can be read off the game thread
+	bool ReadLevelChunk(FName LevelName, FLevelSaveData& OutLevelData, FSaveNameTable& NameTable, const FSaveBlobPool* BlobPool, FSavePlacedTransforms* Placed = nullptr,
+		TArray<int32>* OutClassPaths = nullptr) const;
+
+	//Same as ReadLevelChunk, but the records are decoded in place and their blobs point into the chunk instead of being copied out.
+	//bDeferClasses leaves the classes to FSaveLevelView::ResolveClasses on the game thread
+	bool ReadLevelView(FName LevelName, FSaveLevelView& OutView, FSaveNameTable& NameTable, const FSaveBlobPool* BlobPool, FSavePlacedTransforms* Placed = nullptr,
+		bool bDeferClasses = false) const;
+
+	//Keys a pooled level chunk references, read without decoding its records
+	bool ReadPooledBlobKeys(const FSaveChunkEntry& Entry, TArray<FSaveBlobKey>& OutKeys) const;
+
+public:
+
+	//With Codec None the chunk is left raw so CompressChunks can compress it later
+	static void BuildNameTableChunk(FSaveNameTable& NameTable, FSaveChunkData& OutChunk, ESaveChunkCodec Codec = ESaveChunkCodec::Zlib);
+	static void BuildPlayerChunk(FPlayerSavedata& PlayerData, FSaveNameTable& NameTable, FSaveChunkData& OutChunk, ESaveChunkCodec Codec = ESaveChunkCodec::Zlib);
+	//Blobs go into BlobPool when one is given, they are only queued there until the pool is flushed.
+	//Placed actors only write the transform parts that differ from their entry in Placed
+	static void BuildLevelChunk(FName LevelName, FLevelSaveData& LevelData, FSaveNameTable& NameTable, FSaveBlobPool* BlobPool, FSaveChunkData& OutChunk,
+		ESaveChunkCodec Codec = ESaveChunkCodec::Zlib, FSavePlacedTransforms* Placed = nullptr);
+
+	static void CompressChunk(ESaveChunkType Type, FName Key, const TArray<uint8>& RawData, ESaveChunkCodec Codec, FSaveChunkData& OutChunk);
+
+	//Compresses every chunk still stored raw, spread over the task graph unless bParallel is false.
+	//Returns the seconds all workers spent compressing together
+	static double CompressChunks(TArray<FSaveChunkData>& Chunks, ESaveChunkCodec Codec, bool bParallel);
+
+	//Codec that is actually written for Codec in this build
+	static ESaveChunkCodec GetAvailableCodec(ESaveChunkCodec Codec);
+
+	static bool DecompressChunk(const FSaveChunkEntry& Entry, TArrayView<const uint8> RawData, TArray<uint8>& OutData);
+
+	//Decompresses RawData straight into OutData, which has room for UncompressedSize bytes
+	static bool DecompressMemory(ESaveChunkCodec Codec, TArrayView<const uint8> RawData, uint8* OutData, int64 UncompressedSize);
+
+	//Writes Chunks into the slot. Chunks not being replaced are kept from SourceSlotName, which may be the same slot
+	static bool WriteChunks(const FString& SlotName, const FString& SourceSlotName, const TArray<FSaveChunkData>& Chunks, const FSaveSlotInfo& SlotInfo);
+
+	static void SerializePlayerChunk(FArchive& Ar, FPlayerSavedata& PlayerData);
+	static void SerializeLevelChunk(FArchive& Ar, FLevelSaveData& LevelData, ESaveChunkEncoding Encoding, FSaveChunkBlobs* Blobs = nullptr, FSavePlacedTransforms* Placed = nullptr);
+
+private:
+
+	static bool AppendChunks(const FSaveSlotFile& Existing, const TArray<FSaveChunkData>& Chunks, const FSaveSlotInfo& SlotInfo);
+	static bool RewriteSlot(const FString& TargetPath, const FSaveSlotFile* Source, const TArray<FSaveChunkData>& Chunks, const FSaveSlotInfo& SlotInfo);
+
+	static void MergeEntries(TArray<FSaveChunkEntry>& Entries, const FSaveChunkEntry& NewEntry);
+	static bool WriteTocAndHeader(IFileHandle* Handle, const TArray<FSaveChunkEntry>& Entries, const FSaveSlotInfo& SlotInfo);
+
+	//Always reads or writes exactly the fixed slot info size, in the layout of the given slot version
+	static void SerializeSlotInfo(FArchive& Ar, FSaveSlotInfo& SlotInfo, int32 Version);
+
+	//Writes a flag byte and only the transform parts that differ from the identity transform and are not in PlacedParts.
+	//Loading fills PlacedParts, those parts are left at the identity for the caller to take from the placed transform
+	static void SerializeDeltaTransform(FArchive& Ar, FTransform& Transform, uint8& PlacedParts);
+
+	//Writes large blobs as a reference into Blobs and small ones inline
+	static void SerializeBlob(FArchive& Ar, TArray<uint8>& Data, FSaveChunkBlobs* Blobs);
+
+	//Reads the record layout of SerializeLevelChunk into View, PooledOffsets locates the pooled blobs of pooled chunks
+	static void SerializeLevelView(FArchive& Ar, FSaveLevelView& View, ESaveChunkEncoding Encoding, const TArray<int64>* PooledOffsets, FSavePlacedTransforms* Placed);
+
+	//Reads a blob written by SerializeBlob as a view into the buffers of View
+	static void ReadBlobView(FArchive& Ar, const FSaveLevelView& View, const TArray<int64>* PooledOffsets, TArrayView<const uint8>& OutData);
+
+	//Bytes in front of the first chunk for a slot of the given version
+	static int64 GetHeaderSize(int32 Version);
+
+	//Parses the header and table of contents, read from Handle or from Bytes when Handle is null
+	bool ReadHeaderAndToc(const FString& SlotName, IFileHandle* Handle);
+
+	bool ReadBytes(IFileHandle* Handle, int64 Offset, uint8* OutData, int64 Size) const;
+
+private:
+
+	FString Path;
+
+	FSaveSlotHeader Header;
+
+	FSaveSlotInfo Info;
+
+	TArray<FSaveChunkEntry> Entries;
+
+	int64 FileSize = 0;
+
+	//Set when the slot was opened from memory
+	FSaveSlotBytesPtr Bytes;
+};
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaveSlotInfo.generated.h"
+
+//Summary of a save slot, read from the fixed size slot header without touching the chunks
+USTRUCT(BlueprintType)
+struct SHADOWOFTHEOTHERSIDE_API FSaveSlotInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save Slot")
+		FString SlotName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save Slot")
+		FName LevelName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save Slot")
+		FTransform PlayerTransform;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save Slot")
+		float PlayTimeSeconds = 0.0f;
+
+	//UTC time the slot was last written
+	UPROPERTY(BlueprintReadOnly, Category = "Save Slot")
+		FDateTime Timestamp;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save Slot")
+		int32 FormatVersion = 0;
+};
@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveSlotPrefetch.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Async/Async.h"
+#include "Templates/UniquePtr.h"
+#include "SaveJournal.h"
+
+namespace SaveSlotPrefetch
+{
+	//Size and timestamp are taken before a file is read, anything written to it since moves at least one of them
+	bool IsUnchanged(const FString& Path, int64 Size, const FDateTime& Timestamp)
+	{
+		return IFileManager::Get().GetTimeStamp(*Path) == Timestamp && IFileManager::Get().FileSize(*Path) == Size;
+	}
+}
+
+const int64 FSaveSlotPrefetch::BlockSize = 1024 * 1024;
+
+TSharedRef<FSaveSlotPrefetch, ESPMode::ThreadSafe> FSaveSlotPrefetch::Start(const FString& SlotName, const FString& PoolPath, int64 MaxBytes)
+{
+	TSharedRef<FSaveSlotPrefetch, ESPMode::ThreadSafe> Prefetch = MakeShared<FSaveSlotPrefetch, ESPMode::ThreadSafe>();
+	Prefetch->SlotName = SlotName;
+	Prefetch->Pool.SetPath(PoolPath);
+
+	//The worker keeps the prefetch alive, a cancelled one is let go as soon as the current block is read
+	Prefetch->Task = Async(EAsyncExecution::ThreadPool, [Prefetch, MaxBytes]()
+		{
+			Prefetch->Read(MaxBytes);
+		});
+
+	return Prefetch;
+}
+
+void FSaveSlotPrefetch::Cancel()
+{
+	bCancelled = true;
+}
+
+int64 FSaveSlotPrefetch::GetAllocatedSize() const
+{
+	if (!IsComplete())
+		return 0;
+
+	return (SlotFile.IsInMemory() ? FileSize : 0) + JournalData.Num() + PooledBytes;
+}
+
+void FSaveSlotPrefetch::Read(int64 MaxBytes)
+{
+	const FString SlotPath = FSaveSlotFile::GetSlotPath(SlotName);
+
+	//Taken before the read, a save landing during it moves the timestamp past this and the prefetch is not used
+	Timestamp = IFileManager::Get().GetTimeStamp(*SlotPath);
+
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*SlotPath));
+
+	if (!Handle.IsValid())
+		return;
+
+	FileSize = Handle->Size();
+
+	//Over the cap the header and table of contents are still parsed ahead, the chunks are read from disk by the load
+	if (FileSize > MaxBytes || FileSize > MAX_int32)
+	{
+		Handle.Reset();
+		bOpened = SlotFile.Open(SlotName);
+
+		UE_LOG(LogTemp, Log, TEXT("Prefetch of %s is %lld bytes, over the %lld byte cap, only its table of contents was read"), *SlotName, FileSize, MaxBytes);
+		return;
+	}
+
+	TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Bytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+	Bytes->SetNumUninitialized((int32)FileSize);
+
+	for (int64 Offset = 0; Offset < FileSize; Offset += BlockSize)
+	{
+		if (bCancelled)
+			return;
+
+		if (!Handle->Read(Bytes->GetData() + Offset, FMath::Min(BlockSize, FileSize - Offset)))
+			return;
+	}
+
+	//Legacy slots fail to open here, they are deserialized from disk as a whole
+	bOpened = !bCancelled && SlotFile.Open(SlotName, Bytes);
+
+	if (!bOpened)
+		return;
+
+	int64 Budget = MaxBytes - FileSize;
+	Budget -= ReadJournal(Budget);
+	ReadPool(Budget);
+}
+
+int64 FSaveSlotPrefetch::ReadJournal(int64 Budget)
+{
+	const FString JournalPath = FSaveJournal::GetJournalPath(SlotName, SlotFile.GetInfo().Timestamp.GetTicks());
+
+	JournalTimestamp = IFileManager::Get().GetTimeStamp(*JournalPath);
+	JournalSize = IFileManager::Get().FileSize(*JournalPath);
+
+	//No journal is the common case, the slot was written last
+	if (bCancelled || JournalSize <= 0 || JournalSize > Budget || JournalSize > MAX_int32)
+		return 0;
+
+	bJournalRead = FFileHelper::LoadFileToArray(JournalData, *JournalPath, FILEREAD_Silent) && JournalData.Num() == JournalSize;
+
+	if (!bJournalRead)
+		JournalData.Empty();
+
+	return JournalData.Num();
+}
+
+int64 FSaveSlotPrefetch::ReadPool(int64 Budget)
+{
+	//Only the level the slot was saved in, it is the one the load reads first. Streamed levels read their blobs when they come in
+	const FSaveChunkEntry* Entry = SlotFile.FindChunk(ESaveChunkType::Level, SlotFile.GetInfo().LevelName);
+
+	TArray<FSaveBlobKey> Keys;
+
+	if (bCancelled || Budget <= 0 || Entry == nullptr || !SlotFile.ReadPooledBlobKeys(*Entry, Keys) || Keys.Num() == 0)
+		return 0;
+
+	PoolTimestamp = IFileManager::Get().GetTimeStamp(*Pool.GetPath());
+	PoolSize = IFileManager::Get().FileSize(*Pool.GetPath());
+
+	if (PoolSize <= 0 || !Pool.Open())
+		return 0;
+
+	PooledBytes = Pool.Preload(Keys, Budget);
+	bPoolRead = !bCancelled;
+
+	return PooledBytes;
+}
+
+bool FSaveSlotPrefetch::GetSlotFile(FSaveSlotFile& OutFile) const
+{
+	Task.Wait();
+
+	if (bCancelled || !bOpened)
+		return false;
+
+	if (!SaveSlotPrefetch::IsUnchanged(FSaveSlotFile::GetSlotPath(SlotName), FileSize, Timestamp))
+		return false;
+
+	OutFile = SlotFile;
+	return true;
+}
+
+const TArray<uint8>* FSaveSlotPrefetch::GetJournal() const
+{
+	Task.Wait();
+
+	if (bCancelled || !bJournalRead)
+		return nullptr;
+
+	//Batches appended since the read are not in it, the journal is read from disk again
+	if (!SaveSlotPrefetch::IsUnchanged(FSaveJournal::GetJournalPath(SlotName, SlotFile.GetInfo().Timestamp.GetTicks()), JournalSize, JournalTimestamp))
+		return nullptr;
+
+	return &JournalData;
+}
+
+const FSaveBlobPool* FSaveSlotPrefetch::GetBlobPool() const
+{
+	Task.Wait();
+
+	if (bCancelled || !bPoolRead)
+		return nullptr;
+
+	//The preloaded blobs are checked against their keys either way, but the index of a flushed or compacted pool is stale
+	if (!SaveSlotPrefetch::IsUnchanged(Pool.GetPath(), PoolSize, PoolTimestamp))
+		return nullptr;
+
+	return &Pool;
+}
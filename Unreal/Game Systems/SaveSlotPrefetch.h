@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "SaveSlotFile.h"
+#include "SaveBlobPool.h"
+
+/**
+ * Reads a whole slot file into memory on a worker ahead of the load that wants it, e.g. while the main menu is up.
+ * The file is read in blocks so a cancel takes effect within one block, slots larger than the memory cap only get their header and table of contents parsed.
+ * What the cap leaves goes to the journal of the slot and the pooled blobs of the level the slot was saved in.
+ * A load takes the slot file opened from memory and reads every chunk out of it without touching the disk.
+ * Each file is only handed out while its size and timestamp are still the ones it was read with.
+ */
+class SHADOWOFTHEOTHERSIDE_API FSaveSlotPrefetch
+{
+public:
+
+	//Bytes read between two checks for a cancel
+	static const int64 BlockSize;
+
+public:
+
+	//Starts reading SlotName and the blobs it references from the pool at PoolPath, MaxBytes caps the memory the prefetch may hold
+	static TSharedRef<FSaveSlotPrefetch, ESPMode::ThreadSafe> Start(const FString& SlotName, const FString& PoolPath, int64 MaxBytes);
+
+	//Stops the read at the next block and drops what was read, loads fall back to the disk
+	void Cancel();
+
+	FORCEINLINE bool IsCancelled() const { return bCancelled; }
+
+	FORCEINLINE bool IsComplete() const { return Task.IsReady(); }
+
+	FORCEINLINE const FString& GetSlotName() const { return SlotName; }
+
+	//Memory held by the read slot, journal and blobs, 0 while the read is still running
+	int64 GetAllocatedSize() const;
+
+	//Waits for the read and opens OutFile from it. False when it was cancelled, failed,
+	//or the slot was written since, the caller then opens the slot from disk.
+	//Safe to call from a worker, only the file timestamp and size are checked on disk
+	bool GetSlotFile(FSaveSlotFile& OutFile) const;
+
+	//Waits for the read like GetSlotFile. Journal of the slot as read, null when it was not read or was appended to since
+	const TArray<uint8>* GetJournal() const;
+
+	//Waits for the read like GetSlotFile. Pool holding the read blobs in memory, other blobs are read from its file.
+	//Null when the pool was not read or was written since
+	const FSaveBlobPool* GetBlobPool() const;
+
+private:
+
+	void Read(int64 MaxBytes);
+
+	//Both return the bytes they hold, Budget is what the cap leaves after the slot
+	int64 ReadJournal(int64 Budget);
+	int64 ReadPool(int64 Budget);
+
+private:
+
+	FString SlotName;
+
+	FThreadSafeBool bCancelled;
+
+	TFuture<void> Task;
+
+	//Written by the worker only, read once Task is ready
+	FSaveSlotFile SlotFile;
+
+	bool bOpened = false;
+
+	int64 FileSize = 0;
+
+	FDateTime Timestamp;
+
+	TArray<uint8> JournalData;
+
+	bool bJournalRead = false;
+
+	int64 JournalSize = 0;
+
+	FDateTime JournalTimestamp;
+
+	FSaveBlobPool Pool;
+
+	bool bPoolRead = false;
+
+	int64 PoolSize = 0;
+
+	FDateTime PoolTimestamp;
+
+	int64 PooledBytes = 0;
+};
+
+typedef TSharedPtr<FSaveSlotPrefetch, ESPMode::ThreadSafe> FSaveSlotPrefetchPtr;
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SaveStats.h"
+
+DEFINE_STAT(STAT_SavePlayer);
+DEFINE_STAT(STAT_SaveGatherActors);
+DEFINE_STAT(STAT_SaveCaptureLevel);
+DEFINE_STAT(STAT_SaveSerializeActor);
+DEFINE_STAT(STAT_SaveSerializeParallel);
+DEFINE_STAT(STAT_SaveTimeSlice);
+DEFINE_STAT(STAT_SaveBuildChunks);
+DEFINE_STAT(STAT_SaveCompressChunks);
+DEFINE_STAT(STAT_SaveWriteSlot);
+DEFINE_STAT(STAT_SaveJournalFlush);
+DEFINE_STAT(STAT_SaveCacheComponents);
+
+DEFINE_STAT(STAT_LoadReadSlot);
+DEFINE_STAT(STAT_LoadMatchActors);
+DEFINE_STAT(STAT_LoadApplyActor);
+DEFINE_STAT(STAT_LoadStreamingLevel);
+DEFINE_STAT(STAT_LoadSpawnActor);
+DEFINE_STAT(STAT_LoadLoadedCallbacks);
+
+DEFINE_STAT(STAT_SaveActorsVisited);
+DEFINE_STAT(STAT_SaveBlobsWritten);
+DEFINE_STAT(STAT_SaveBlobBytesWritten);
+DEFINE_STAT(STAT_LoadActorsApplied);
+DEFINE_STAT(STAT_LoadActorsSpawned);
+DEFINE_STAT(STAT_LoadActorsDestroyed);
+
+UE_TRACE_CHANNEL_DEFINE(SaveChannel);
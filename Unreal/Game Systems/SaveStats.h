@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+//"stat SaveSubsystem" in game, or the SaveChannel trace channel in Insights: -trace=cpu,SaveChannel
+DECLARE_STATS_GROUP(TEXT("Save Subsystem"), STATGROUP_SaveSubsystem, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Player"), STAT_SavePlayer, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Gather Actors"), STAT_SaveGatherActors, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Capture Level"), STAT_SaveCaptureLevel, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Serialize Actor"), STAT_SaveSerializeActor, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Serialize Parallel"), STAT_SaveSerializeParallel, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Time Slice"), STAT_SaveTimeSlice, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Build Chunks"), STAT_SaveBuildChunks, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Compress Chunks"), STAT_SaveCompressChunks, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Write Slot"), STAT_SaveWriteSlot, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Journal Flush"), STAT_SaveJournalFlush, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Cache Components"), STAT_SaveCacheComponents, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Read Slot"), STAT_LoadReadSlot, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Match Actors"), STAT_LoadMatchActors, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Apply Actor"), STAT_LoadApplyActor, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Streaming Level"), STAT_LoadStreamingLevel, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Spawn Actor"), STAT_LoadSpawnActor, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Loaded Callbacks"), STAT_LoadLoadedCallbacks, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+
+//Counters are cleared every frame, a hitch shows how much work landed in that frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors Visited"), STAT_SaveActorsVisited, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blobs Written"), STAT_SaveBlobsWritten, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blob Bytes Written"), STAT_SaveBlobBytesWritten, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors Loaded"), STAT_LoadActorsApplied, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors Spawned"), STAT_LoadActorsSpawned, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors Destroyed"), STAT_LoadActorsDestroyed, STATGROUP_SaveSubsystem, SHADOWOFTHEOTHERSIDE_API);
+
+UE_TRACE_CHANNEL_EXTERN(SaveChannel, SHADOWOFTHEOTHERSIDE_API);
+
+//Times a phase in the stat group and marks it in Insights under the same name
+#define SAVE_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, SaveChannel)
+
+//Marks the work done for one actor under its class name, the name is only built while the channel is traced
+#define SAVE_TRACE_CLASS_SCOPE(Class) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(UE_TRACE_CHANNELEXPR_IS_ENABLED(SaveChannel) ? *(Class)->GetName() : TEXT(""), SaveChannel)
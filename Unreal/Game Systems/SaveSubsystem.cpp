@@ -4,199 +4,2508 @@
 #include "SaveSubsystem.h"
 #include "Kismet/GameplayStatics.h"
 #include "MainSaveGame.h"	
-#include "EngineUtils.h"
-#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
 #include "SaveLoadActorInterface.h"
 #include "PlayableCharacter.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Async/Async.h"
+#include "Misc/Compression.h"
+#include "SaveSlotFile.h"
+#include "HAL/FileManager.h"
+#include "SaveNameTableArchive.h"
+#include "SaveObjectRegistry.h"
+#include "SaveSerializationInterface.h"
+#include "PhysicsDoor.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Containers/Ticker.h"
+#include "SaveStats.h"
+#include "SaveComponentLayout.h"
+
+namespace SaveSubsystemFile
+{
+	static const uint32 CompressedSlotTag = 0x56415352;
+
+	//Records an async write serializes, copied off the save object on the game thread
+	struct FWriteRecords
+	{
+		FPlayerSavedata PlayerData;
+
+		TArray<TPair<FName, FLevelSaveData>> Levels;
+
+		//Placed transforms of those levels, what their records are written against
+		TMap<FName, FSavePlacedTransforms> PlacedTransforms;
+	};
+
+	//Reads slots written before the chunked layout, either raw GVAS objects or one compressed object
+	static USaveGame* LoadSaveGameFromSlot(const FString& SlotName, int32 UserIndex)
+	{
+		ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+
+		TArray<uint8> FileData;
+
+		if (SaveSystem == nullptr || !SaveSystem->LoadGame(false, *SlotName, UserIndex, FileData))
+			return nullptr;
+
+		FMemoryReader Reader(FileData);
+
+		uint32 Tag = 0;
+		Reader << Tag;
+
+		if (Tag != CompressedSlotTag)
+			return UGameplayStatics::LoadGameFromMemory(FileData);
+
+		int32 Version = 0;
+		int64 UncompressedSize = 0;
+
+		Reader << Version << UncompressedSize;
+
+		if (Reader.IsError() || UncompressedSize <= 0 || UncompressedSize > MAX_int32)
+			return nullptr;
+
+		TArray<uint8> RawData;
+		RawData.SetNumUninitialized((int32)UncompressedSize);
+
+		const int32 Offset = (int32)Reader.Tell();
+
+		if (!FCompression::UncompressMemory(NAME_Zlib, RawData.GetData(), RawData.Num(), FileData.GetData() + Offset, FileData.Num() - Offset))
+			return nullptr;
+
+		return UGameplayStatics::LoadGameFromMemory(RawData);
+	}
+}
+
+namespace SaveSubsystemSnapshot
+{
+	static int64 GetComponentBytes(const TArray<FActorComponentSaveData>& Components)
+	{
+		int64 Bytes = Components.GetAllocatedSize();
+
+		for (const FActorComponentSaveData& Component : Components)
+		{
+			Bytes += Component.BinaryData.GetAllocatedSize();
+		}
+
+		return Bytes;
+	}
+
+	//Heap the records hold, close enough to keep the ring under its cap
+	static int64 GetSnapshotBytes(const TMap<FName, FLevelSaveData>& Levels, const FPlayerSavedata& PlayerData)
+	{
+		int64 Bytes = Levels.GetAllocatedSize();
+
+		for (const TPair<FName, FLevelSaveData>& Pair : Levels)
+		{
+			Bytes += Pair.Value.LevelActorData.GetAllocatedSize();
+
+			for (const FActorSaveData& Record : Pair.Value.LevelActorData)
+			{
+				Bytes += Record.BinaryData.GetAllocatedSize() + GetComponentBytes(Record.ComponentsSaveData);
+			}
+		}
+
+		Bytes += PlayerData.CharacterBinaryData.GetAllocatedSize() + PlayerData.ControllerBinaryData.GetAllocatedSize() + PlayerData.ControllerCustomData.GetAllocatedSize();
+		Bytes += GetComponentBytes(PlayerData.CharacterComponentsSaveData) + GetComponentBytes(PlayerData.ControllerComponentsSaveData);
+
+		return Bytes;
+	}
+}
+
+namespace SaveSubsystemBenchmark
+{
+	//SaveSubsystem.BenchmarkParallelSerialize [ActorCount] [ActorClassPath], defaults to 4000 physics doors
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkParallelSerializeCommand(
+		TEXT("SaveSubsystem.BenchmarkParallelSerialize"),
+		TEXT("Spawns actors into a throwaway world and times serializing their save records over 1, 4 and 16 workers"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(World);
+
+			if (SaveSubsystem == nullptr)
+				return;
+
+			const int32 ActorCount = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 4000;
+			UClass* ActorClass = Args.Num() > 1 ? LoadClass<AActor>(nullptr, *Args[1]) : APhysicsDoor::StaticClass();
+
+			SaveSubsystem->BenchmarkParallelSerialize(ActorClass, ActorCount);
+		}));
+}
+
+namespace SaveSubsystemReport
+{
+	//SaveSubsystem.Report [MaxClasses], cost of the last save and load per phase and per actor class
+	static FAutoConsoleCommandWithWorldAndArgs ReportCommand(
+		TEXT("SaveSubsystem.Report"),
+		TEXT("Logs the phase timings of the last save and load and the actor classes that cost the most"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(World))
+				SaveSubsystem->PrintCostReport(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0);
+		}));
+
+	static int64 GetRecordBytes(const FActorSaveData& Record)
+	{
+		int64 Bytes = Record.BinaryData.Num();
+
+		for (const FActorComponentSaveData& Component : Record.ComponentsSaveData)
+		{
+			Bytes += Component.BinaryData.Num();
+		}
+
+		return Bytes;
+	}
+
+	static void PrintClassCosts(const TCHAR* Operation, const TMap<FObjectKey, FSaveClassCost>& Costs, int32 MaxClasses)
+	{
+		TArray<FSaveClassCost> Sorted;
+		Costs.GenerateValueArray(Sorted);
+
+		//Most expensive first
+		Sorted.Sort([](const FSaveClassCost& A, const FSaveClassCost& B)
+			{
+				return A.Seconds > B.Seconds;
+			});
+
+		if (MaxClasses > 0 && Sorted.Num() > MaxClasses)
+			Sorted.SetNum(MaxClasses);
+
+		UE_LOG(LogTemp, Display, TEXT("  %-40s %8s %8s %10s %10s %8s %9s"), TEXT("Class"), TEXT("Actors"), TEXT("Blobs"), TEXT("KB"), TEXT("Ms"), TEXT("Spawned"), TEXT("Destroyed"));
+
+		for (const FSaveClassCost& Cost : Sorted)
+		{
+			UE_LOG(LogTemp, Display, TEXT("  %-40s %8d %8d %10.1f %10.3f %8d %9d"), *Cost.ClassName.ToString(), Cost.Actors, Cost.Blobs,
+				Cost.Bytes / 1024.0, Cost.Seconds * 1000.0, Cost.Spawned, Cost.Destroyed);
+		}
+
+		if (Sorted.Num() == 0)
+			UE_LOG(LogTemp, Display, TEXT("  No %s since the subsystem started"), Operation);
+	}
+}
+
+void USaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PlayTimeStart = FPlatformTime::Seconds();
+
+	PostWorldInitHandle = FWorldDelegates::OnPostWorldInitialization.AddUObject(this, &USaveSubsystem::OnPostWorldInitialization);
+}
+
+
+void USaveSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnPostWorldInitialization.Remove(PostWorldInitHandle);
+
+	if (LevelLoadTickHandle.IsValid())
+		FTicker::GetCoreTicker().RemoveTicker(LevelLoadTickHandle);
+
+	CancelTimeSlicedSave();
+	CancelRespawns();
+
+	if (JournalTickHandle.IsValid())
+		FTicker::GetCoreTicker().RemoveTicker(JournalTickHandle);
+
+	JournalTickHandle.Reset();
+
+	//The worker still uses the name table and the blob pool, it has to finish before the subsystem goes away
+	if (SaveTask.IsValid())
+		SaveTask.Wait();
+
+	//A load being prepared reads the blob pool
+	if (LoadTask.IsValid())
+		LoadTask.Wait();
+
+	CancelPrefetch();
+
+	//Whatever is still queued and alive goes into the journal before the game instance is gone
+	FlushJournal();
+	WaitForJournal();
+
+	Super::Deinitialize();
+}
+
+void USaveSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	USaveSubsystem* This = CastChecked<USaveSubsystem>(InThis);
+
+	for (TPair<FName, FSaveLevelViewPtr>& Pair : This->LevelViews)
+	{
+		Pair.Value->AddReferencedObjects(Collector);
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void USaveSubsystem::SaveGame(UObject* WorldContext, FString SlotName)
+{
+	//The world is about to be replaced by the load, there is nothing worth saving yet
+	if (bLoadInFlight)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Save to %s ignored while LoadGameAsync is preparing a slot"), *SlotName);
+		return;
+	}
+
+	FlushRespawns();
+
+	//A write is still in flight, remember the latest request and run it once the write finishes
+	if (bSaveInFlight || TimeSlicedSave.bActive)
+	{
+		bSavePending = true;
+		bPendingTimeSliced = false;
+		PendingSaveSlotName = SlotName;
+		PendingSaveWorldContext = WorldContext;
+
+		return;
+	}
+
+	if (SaveGameSlot == nullptr)
+		SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
+
+	LastSaveTimings = FSavePhaseTimings();
+	LastSaveClassCosts.Reset();
+
+	double PhaseStart = FPlatformTime::Seconds();
+
+	SavePlayer(WorldContext);
+
+	LastSaveTimings.SerializeSeconds += FPlatformTime::Seconds() - PhaseStart;
+	PhaseStart = FPlatformTime::Seconds();
+
+	UWorld* World = WorldContext->GetWorld();
+
+	//Streamed sublevels keep their own records, every loaded level replaces its record set
+	TMap<ULevel*, TArray<AActor*>> LevelActors;
+	GatherLevelActors(World, LevelActors);
+
+	LastSaveTimings.IterateSeconds += FPlatformTime::Seconds() - PhaseStart;
+	PhaseStart = FPlatformTime::Seconds();
+
+	for (TPair<ULevel*, TArray<AActor*>>& Pair : LevelActors)
+	{
+		CaptureLevel(Pair.Key, Pair.Value);
+	}
+
+	LastSaveTimings.SerializeSeconds += FPlatformTime::Seconds() - PhaseStart;
+
+	DirtyActors.Reset();
+
+	WriteSaveGameAsync(SlotName);
+	PushSnapshot(SlotName, World);
+}
+
+void USaveSubsystem::CaptureLevel(ULevel* Level, const TArray<AActor*>& Actors)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveCaptureLevel);
+	INC_DWORD_STAT_BY(STAT_SaveActorsVisited, Actors.Num());
+
+	const FName LevelName = GetLevelSaveName(Level);
+	USaveObjectRegistry* Registry = Level->OwningWorld->GetSubsystem<USaveObjectRegistry>();
+
+	UpdatePlacedTransforms(Level);
+
+	//In incremental mode clean actors move their previous record over instead of reserializing.
+	//The write in flight has its own copy, the records in SaveGameSlot may be moved out while it runs
+	FLevelSaveData* PreviousLevelData = bIncrementalSave ? FindLevelRecords(LevelName, false) : nullptr;
+
+	TMap<FName, int32> PreviousIndex;
+
+	if (PreviousLevelData != nullptr)
+		BuildActorRecordIndex(*PreviousLevelData, PreviousIndex);
+
+	TArray<FActorSaveData> ActorSave;
+	TArray<UActorComponent*> Components;
+	TArray<FActorSerializeJob> ParallelJobs;
+
+	ActorSave.Reserve(Actors.Num());
+
+	for (AActor* Actor : Actors)
+	{
+		if (IsActorAPlayer(Actor))
+			continue;
+
+		const int32* PreviousRecord = PreviousIndex.Find(Actor->GetFName());
+
+		if (PreviousRecord != nullptr && !DirtyActors.Contains(Actor))
+		{
+			FActorSaveData& Data = PreviousLevelData->LevelActorData[*PreviousRecord];
+			Data.Transform = Actor->GetActorTransform();
+
+			FindClassCost(LastSaveClassCosts, Actor->GetClass()).Actors++;
+
+			ActorSave.Add(MoveTemp(Data));
+			continue;
+		}
+
+		Registry->GetSaveComponents(Actor, Components);
+
+		if (bParallelSerialize && CanSerializeOffGameThread(Actor, Components))
+		{
+			FActorSerializeJob& Job = ParallelJobs.AddDefaulted_GetRef();
+			Job.Actor = Actor;
+			Job.Components = Components;
+			Job.RecordIndex = ActorSave.AddDefaulted();
+
+			BeginActorRecord(Actor, ActorSave[Job.RecordIndex]);
+			continue;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		FActorSaveData Data;
+		SaveActorData(Actor, Components, Data);
+
+		RecordSavedActor(Actor->GetClass(), Data, FPlatformTime::Seconds() - StartTime);
+
+		ActorSave.Add(MoveTemp(Data));
+	}
+
+	//Records were reserved in registry order above, so the result does not depend on which worker finishes first
+	if (ParallelJobs.Num() > 0)
+	{
+		const int32 Workers = ParallelJobs.Num() < ParallelSerializeMinActors ? 1
+			: MaxSerializeWorkers > 0 ? MaxSerializeWorkers : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+
+		TArray<double> JobSeconds;
+		SerializeActorsParallel(ParallelJobs, ActorSave, NameTable, Workers, &JobSeconds);
+
+		//Components are told after they were serialized, same as SaveComponentData does
+		for (int32 i = 0; i < ParallelJobs.Num(); i++)
+		{
+			const FActorSerializeJob& Job = ParallelJobs[i];
+			RecordSavedActor(Job.Actor->GetClass(), ActorSave[Job.RecordIndex], JobSeconds[i]);
+
+			for (UActorComponent* Component : Job.Components)
+			{
+				ISaveLoadActorInterface::Execute_OnActorSave(Component);
+			}
+		}
+	}
+
+	FLevelSaveData LevelData;
+	LevelData.LevelActorData = MoveTemp(ActorSave);
+
+	StoreLevelRecords(LevelName, MoveTemp(LevelData));
+}
+
+void USaveSubsystem::StoreLevelRecords(FName LevelName, FLevelSaveData&& LevelData)
+{
+	DirtyLevelChunks.Add(LevelName);
+	LevelViews.Remove(LevelName);
+
+	//Merged into SaveGameSlot once the write is done
+	if (bSaveInFlight)
+	{
+		StreamedLevelRecords.FindOrAdd(LevelName) = MoveTemp(LevelData);
+		return;
+	}
+
+	SaveGameSlot->WorldActorData.FindOrAdd(LevelName) = MoveTemp(LevelData);
+}
+
+FLevelSaveData* USaveSubsystem::FindLevelRecords(FName LevelName, bool bReadChunk)
+{
+	if (SaveGameSlot == nullptr)
+		return nullptr;
+
+	FLevelSaveData* LevelData = StreamedLevelRecords.Find(LevelName);
+
+	if (LevelData == nullptr)
+		LevelData = SaveGameSlot->WorldActorData.Find(LevelName);
+
+	if (LevelData != nullptr)
+		return LevelData;
+
+	const FSaveLevelViewPtr View = LevelViews.FindRef(LevelName);
+
+	if (!View.IsValid() && (!bReadChunk || LoadedSlotName.IsEmpty()))
+		return nullptr;
+
+	//The slot may be rewritten under the read while a write is in flight, until it is done only levels in memory are found
+	if (!View.IsValid() && bSaveInFlight)
+		return nullptr;
+
+	FLevelSaveData ChunkData;
+
+	if (View.IsValid())
+	{
+		View->Materialize(ChunkData, &PlacedTransforms.FindOrAdd(LevelName));
+		LevelViews.Remove(LevelName);
+	}
+	else
+	{
+		FSaveSlotFile SlotFile;
+
+		if (!SlotFile.Open(LoadedSlotName) || !SlotFile.ReadLevelChunk(LevelName, ChunkData, NameTable, BlobPool.Open() ? &BlobPool : nullptr, &PlacedTransforms.FindOrAdd(LevelName)))
+			return nullptr;
+	}
+
+	return &SaveGameSlot->WorldActorData.Add(LevelName, MoveTemp(ChunkData));
+}
+
+FSaveLevelViewPtr USaveSubsystem::GetLevelView(FName LevelName, bool bReadChunk)
+{
+	if (SaveGameSlot == nullptr)
+		return nullptr;
+
+	const FLevelSaveData* LevelData = StreamedLevelRecords.Find(LevelName);
+
+	if (LevelData == nullptr)
+		LevelData = SaveGameSlot->WorldActorData.Find(LevelName);
+
+	if (LevelData != nullptr)
+	{
+		FSaveLevelViewPtr View = MakeShared<FSaveLevelView, ESPMode::ThreadSafe>();
+		View->Reference(*LevelData, PlacedTransforms.Find(LevelName));
+
+		return View;
+	}
+
+	if (const FSaveLevelViewPtr* View = LevelViews.Find(LevelName))
+		return *View;
+
+	if (!bReadChunk || LoadedSlotName.IsEmpty())
+		return nullptr;
+
+	//The slot may be rewritten under the read while a write is in flight, LoadStreamingLevel defers such levels until it is done
+	if (bSaveInFlight)
+		return nullptr;
+
+	FSaveSlotFile SlotFile;
+	FSaveLevelViewPtr View = MakeShared<FSaveLevelView, ESPMode::ThreadSafe>();
+
+	if (!SlotFile.Open(LoadedSlotName) || !SlotFile.ReadLevelView(LevelName, *View, NameTable, BlobPool.Open() ? &BlobPool : nullptr, &PlacedTransforms.FindOrAdd(LevelName)))
+		return nullptr;
+
+	LevelViews.Add(LevelName, View);
+	return View;
+}
+
+FName USaveSubsystem::GetLevelSaveName(const ULevel* Level)
+{
+	if (Level->IsPersistentLevel())
+		return Level->OwningWorld->GetFName();
+
+	//Play in editor prefixes the packages of every streamed level, saves have to match the cooked names
+	return FName(*UWorld::RemovePIEPrefix(Level->GetOutermost()->GetName()));
+}
+
+void USaveSubsystem::GatherLevelActors(UWorld* World, TMap<ULevel*, TArray<AActor*>>& OutLevelActors)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveGatherActors);
+
+	for (ULevel* Level : World->GetLevels())
+	{
+		OutLevelActors.Add(Level);
+	}
+
+	USaveObjectRegistry* Registry = World->GetSubsystem<USaveObjectRegistry>();
+
+	if (Registry == nullptr)
+		return;
+
+	TArray<AActor*> SaveObjects;
+	Registry->GetSaveObjects(SaveObjects);
+
+	for (AActor* Actor : SaveObjects)
+	{
+		if (TArray<AActor*>* Actors = OutLevelActors.Find(Actor->GetLevel()))
+			Actors->Add(Actor);
+	}
+}
+
+void USaveSubsystem::SaveStreamingLevel(ULevel* Level)
+{
+	UWorld* World = Level != nullptr ? Level->OwningWorld : nullptr;
+	USaveObjectRegistry* Registry = World != nullptr ? World->GetSubsystem<USaveObjectRegistry>() : nullptr;
+
+	//A world being torn down takes its sublevels with it, there is nothing left to stream back in
+	if (Registry == nullptr || Level->IsPersistentLevel() || World->bIsTearingDown || World->GetGameInstance() != GetGameInstance())
+		return;
+
+	//Progress made in a sublevel before the first save still has to survive it streaming out
+	if (SaveGameSlot == nullptr)
+		SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
+
+	//Streamed out again before its records were applied, its actors don't hold the saved state and the records stay as they are
+	if (DeferredStreamingLevels.Remove(Level) > 0)
+		return;
+
+	TArray<AActor*> Actors;
+	Registry->GetSaveObjects(Level, Actors);
+
+	CaptureLevel(Level, Actors);
+}
+
+void USaveSubsystem::LoadStreamingLevel(ULevel* Level)
+{
+	UWorld* World = Level != nullptr ? Level->OwningWorld : nullptr;
+
+	if (World == nullptr || SaveGameSlot == nullptr || Level->IsPersistentLevel() || World->GetGameInstance() != GetGameInstance())
+		return;
+
+	//Sublevels that are in before play begins are applied with the rest of the world by LoadGame or the level load
+	if (!World->HasBegunPlay() || LevelLoadWorld == World)
+		return;
+
+	const FName LevelName = GetLevelSaveName(Level);
+
+	//A level whose records are only on disk can't be read while the slot is being written, it is applied once the write is done
+	if (bSaveInFlight && !LoadedSlotName.IsEmpty() && !StreamedLevelRecords.Contains(LevelName) && !SaveGameSlot->WorldActorData.Contains(LevelName) && !LevelViews.Contains(LevelName))
+	{
+		DeferredStreamingLevels.AddUnique(Level);
+		return;
+	}
+
+	TArray<int32> Respawns;
+
+	if (ApplyStreamingLevel(Level, true, Respawns))
+		RespawnStreamingLevel(Level, Respawns);
+}
+
+bool USaveSubsystem::ApplyStreamingLevel(ULevel* Level, bool bLoadedCallbacks, TArray<int32>& OutRespawns)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_LoadStreamingLevel);
+
+	USaveObjectRegistry* Registry = Level->OwningWorld->GetSubsystem<USaveObjectRegistry>();
+
+	//Before the records are read, so the ones waiting for this level's placed transforms get them
+	UpdatePlacedTransforms(Level);
+
+	const FSaveLevelViewPtr View = GetLevelView(GetLevelSaveName(Level));
+
+	if (!View.IsValid() || Registry == nullptr)
+		return false;
+
+	View->BuildIndex();
+
+	const TMap<FName, int32>& RecordIndex = View->GetIndex();
+	TBitArray<> MatchedRecords(false, View->Num());
+
+	TArray<AActor*> SaveObjects;
+	TArray<UActorComponent*> Components;
+	TArray<UActorComponent*> LoadedComponents;
+
+	Registry->GetSaveObjects(Level, SaveObjects);
+
+	for (AActor* Actor : SaveObjects)
+	{
+		if (IsActorAPlayer(Actor))
+			continue;
+
+		const int32* Index = RecordIndex.Find(Actor->GetFName());
+
+		//Placed actors without a record were destroyed before the sublevel streamed out or was saved
+		if (Index == nullptr)
+		{
+			RecordDestroyedActor(Actor->GetClass());
+			Actor->Destroy();
+			continue;
+		}
+
+		const FSaveActorView& Record = View->GetActor(*Index);
+		MatchedRecords[*Index] = true;
+
+		Registry->GetSaveComponents(Actor, Components);
+
+		if (bLoadedCallbacks)
+		{
+			LoadActorData(Actor, Components, *View, Record, true);
+			continue;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		Actor->SetActorTransform(GetRecordTransform(Actor, Record));
+		FSaveNameTableArchive::LoadObject(Actor, Record.BinaryData, NameTable);
+
+		TBitArray<> AppliedComponents(false, Record.NumComponents);
+		LoadedComponents.Reset();
+
+		ApplyComponentData(Components, View->GetComponents(Record), AppliedComponents, LoadedComponents);
+
+		RecordLoadedActor(Actor->GetClass(), *View, Record, FPlatformTime::Seconds() - StartTime);
+	}
+
+	OutRespawns.Reset();
+
+	for (int32 i = 0; i < View->Num(); i++)
+	{
+		if (!MatchedRecords[i])
+			OutRespawns.Add(i);
+	}
+
+	return true;
+}
+
+void USaveSubsystem::RespawnStreamingLevel(ULevel* Level, const TArray<int32>& Records)
+{
+	const FSaveLevelViewPtr View = GetLevelView(GetLevelSaveName(Level));
+
+	if (!View.IsValid())
+		return;
+
+	for (int32 Record : Records)
+	{
+		if (View->IsValidIndex(Record))
+			RespawnActor(Level->OwningWorld, *View, View->GetActor(Record), Level);
+	}
+}
+
+void USaveSubsystem::ApplyStreamingLevels(UWorld* World, bool bLoadedCallbacks, TArray<TPair<ULevel*, TArray<int32>>>& OutRespawns)
+{
+	for (ULevel* Level : World->GetLevels())
+	{
+		if (Level->IsPersistentLevel())
+			continue;
+
+		TArray<int32> Respawns;
+
+		if (ApplyStreamingLevel(Level, bLoadedCallbacks, Respawns) && Respawns.Num() > 0)
+			OutRespawns.Emplace(Level, MoveTemp(Respawns));
+	}
+}
+
+void USaveSubsystem::RespawnStreamingLevels(const TArray<TPair<ULevel*, TArray<int32>>>& Respawns)
+{
+	for (const TPair<ULevel*, TArray<int32>>& Pair : Respawns)
+	{
+		RespawnStreamingLevel(Pair.Key, Pair.Value);
+	}
+}
+
+void USaveSubsystem::LoadGame(UObject* WorldContext, FString SlotName)
+{
+	CancelPendingLoads();
+
+	if (!DoesSlotExist(SlotName))
+	{
+		if (SaveTask.IsValid())
+			SaveTask.Wait();
+
+		StartNewSession(WorldContext);
+		return;
+	}
+
+	//Make sure the slot on disk is complete before reading it
+	if (SaveTask.IsValid())
+		SaveTask.Wait();
+
+	LastLoadTimings = FSavePhaseTimings();
+	LastLoadClassCosts.Reset();
+	double PhaseStart = FPlatformTime::Seconds();
+
+	UWorld* World = WorldContext->GetWorld();
+	SaveGameSlot = ReadSaveGameForLevel(SlotName, World);
+
+	LastLoadTimings.ReadSeconds = FPlatformTime::Seconds() - PhaseStart;
+
+	if (SaveGameSlot == nullptr)
+	{
+		StartNewSession(WorldContext);
+		return;
+	}
+
+	ApplyLoadedLevel(WorldContext);
+}
+
+void USaveSubsystem::LoadGameAsync(UObject* WorldContext, FString SlotName)
+{
+	//Nothing to read for a new game, the synchronous path is already instant
+	if (!DoesSlotExist(SlotName))
+	{
+		LoadGame(WorldContext, SlotName);
+		return;
+	}
+
+	CancelPendingLoads();
+
+	//Make sure the slot on disk is complete before reading it
+	if (SaveTask.IsValid())
+		SaveTask.Wait();
+
+	ResetLoadedSession();
+
+	LastLoadTimings = FSavePhaseTimings();
+	LastLoadClassCosts.Reset();
+
+	UWorld* World = WorldContext->GetWorld();
+
+	TSharedRef<FPreparedLoad, ESPMode::ThreadSafe> Load = MakeShared<FPreparedLoad, ESPMode::ThreadSafe>();
+	Load->SlotName = SlotName;
+	Load->LevelName = World->GetFName();
+	Load->bIndexRecords = true;
+	Load->Prefetch = TakePrefetch(SlotName);
+
+	GetLoadedLevelNames(World, Load->LevelNames);
+
+	UpdatePlacedTransforms(World);
+	Load->PlacedTransforms = PlacedTransforms;
+
+	bLoadInFlight = true;
+
+	const int32 RequestId = ++LoadRequestId;
+	FSaveBlobPool* Pool = &BlobPool;
+	TWeakObjectPtr<USaveSubsystem> WeakThis(this);
+	TWeakObjectPtr<UObject> WeakWorldContext(WorldContext);
+
+	//Reading, decompressing, decoding and indexing only touch Load and the pool, the world is left to the game thread
+	LoadTask = Async(EAsyncExecution::ThreadPool, [WeakThis, WeakWorldContext, Load, Pool, RequestId]()
+		{
+			PrepareLoad(*Load, Pool);
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, WeakWorldContext, Load, RequestId]()
+				{
+					if (WeakThis.IsValid())
+						WeakThis->FinishLoadAsync(*Load, WeakWorldContext.Get(), RequestId);
+				});
+		});
+}
+
+void USaveSubsystem::FinishLoadAsync(FPreparedLoad& Load, UObject* WorldContext, int32 RequestId)
+{
+	//Superseded by a later load, or the world it was meant for is gone
+	if (RequestId != LoadRequestId || !bLoadInFlight)
+		return;
+
+	bLoadInFlight = false;
+
+	if (WorldContext == nullptr || WorldContext->GetWorld() == nullptr)
+		return;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	//Legacy slots are whole UObjects, they can only be deserialized here
+	SaveGameSlot = Load.bChunked ? AdoptPreparedLoad(Load) : ReadLegacySaveGame(Load.SlotName);
+
+	LastLoadTimings.WorkerSeconds = Load.ReadSeconds;
+	LastLoadTimings.ReadSeconds = Load.ReadSeconds + FPlatformTime::Seconds() - StartTime;
+
+	if (SaveGameSlot == nullptr)
+	{
+		StartNewSession(WorldContext);
+		return;
+	}
+
+	ApplyLoadedLevel(WorldContext);
+
+	UE_LOG(LogTemp, Log, TEXT("LoadGameAsync %s: worker %.2fms, game thread %.2fms (adopt %.2fms, match %.2fms), respawns follow"),
+		*Load.SlotName, LastLoadTimings.WorkerSeconds * 1000.0, (FPlatformTime::Seconds() - StartTime) * 1000.0,
+		(LastLoadTimings.ReadSeconds - LastLoadTimings.WorkerSeconds) * 1000.0, LastLoadTimings.MatchSeconds * 1000.0);
+}
+
+void USaveSubsystem::WaitForPendingLoad()
+{
+	//The result is posted to the game thread, pump it until the prepared load was applied
+	while (bLoadInFlight)
+	{
+		if (LoadTask.IsValid())
+			LoadTask.Wait();
+
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	}
+
+	FlushRespawns();
+}
+
+void USaveSubsystem::CancelPendingLoads()
+{
+	//The loaded records replace whatever the time sliced save was capturing or the last load was respawning
+	CancelTimeSlicedSave();
+	CancelRespawns();
+
+	if (LevelLoadTickHandle.IsValid())
+		FTicker::GetCoreTicker().RemoveTicker(LevelLoadTickHandle);
+
+	LevelLoadTickHandle.Reset();
+	LevelLoadWorld.Reset();
+
+	//A load still being prepared on a worker is dropped once it arrives
+	bLoadInFlight = false;
+	LoadRequestId++;
+}
+
+void USaveSubsystem::ApplyLoadedLevel(UObject* WorldContext)
+{
+	UWorld* World = WorldContext->GetWorld();
+
+	TArray<TPair<ULevel*, TArray<int32>>> StreamingRespawns;
+	const FSaveLevelViewPtr View = GetLevelView(World->GetFName(), false);
+
+	//If there are no save data for this level then we just call the OnActorLoaded Interface
+	if (!View.IsValid())
+	{
+		//Loaded sublevels may still have records of their own, the callback below covers their actors
+		ApplyStreamingLevels(World, false, StreamingRespawns);
+
+		InitiateOnActorLoadedCallback(WorldContext);
+		RespawnStreamingLevels(StreamingRespawns);
+
+		OnGameFullyLoaded.Broadcast(SaveGameSlot);
+
+		return;
+	}
+
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_LoadMatchActors);
+
+	const double PhaseStart = FPlatformTime::Seconds();
+
+	LoadPlayer(WorldContext);
+
+	//Index the saved records once so every placed actor finds its record in O(1), an async load built it on the worker
+	View->BuildIndex();
+
+	const TMap<FName, int32>& RecordIndex = View->GetIndex();
+	TBitArray<> MatchedRecords(false, View->Num());
+
+	USaveObjectRegistry* Registry = World->GetSubsystem<USaveObjectRegistry>();
+
+	TArray<AActor*> SaveObjects;
+	TArray<UActorComponent*> Components;
+
+	if (Registry != nullptr)
+		Registry->GetSaveObjects(SaveObjects);
+
+	for (AActor* Actor : SaveObjects)
+	{
+		//Actors of streamed sublevels are matched against their own records below
+		if (IsActorAPlayer(Actor) || Actor->GetLevel() != World->PersistentLevel)
+			continue;
+
+		const int32* Index = RecordIndex.Find(Actor->GetFName());
+
+		//Placed actors without a record were destroyed before the level was saved
+		if (Index == nullptr)
+		{
+			RecordDestroyedActor(Actor->GetClass());
+			Actor->Destroy();
+			continue;
+		}
+
+		Registry->GetSaveComponents(Actor, Components);
+
+		MatchedRecords[*Index] = true;
+		LoadActorData(Actor, Components, *View, View->GetActor(*Index), true);
+	}
+
+	ApplyStreamingLevels(World, true, StreamingRespawns);
+
+	LastLoadTimings.MatchSeconds = FPlatformTime::Seconds() - PhaseStart;
+
+	//Records no placed actor claimed belong to actors that were spawned at runtime
+	PendingRespawns.bActive = true;
+	PendingRespawns.World = World;
+	PendingRespawns.View = View;
+
+	for (int32 i = 0; i < View->Num(); i++)
+	{
+		if (!MatchedRecords[i])
+			PendingRespawns.Records.Add(i);
+	}
+
+	//Sublevels only hold a few runtime actors each, they are respawned right away
+	RespawnStreamingLevels(StreamingRespawns);
+
+	//The loaded records match the world now, nothing is dirty until gameplay changes it
+	DirtyActors.Reset();
+
+	OnLoadGame.Broadcast(SaveGameSlot);
+
+	StartRespawns();
+}
+
+void USaveSubsystem::LoadGameOnLevelLoad(FString SlotName)
+{
+	LevelLoadSlotName = SlotName;
+}
+
+void USaveSubsystem::OnPostWorldInitialization(UWorld* World, const UWorld::InitializationValues IVS)
+{
+	if (LevelLoadSlotName.IsEmpty() || World == nullptr || !World->IsGameWorld() || World->GetGameInstance() != GetGameInstance())
+		return;
+
+	const FString SlotName = LevelLoadSlotName;
+	LevelLoadSlotName.Empty();
+
+	CancelPendingLoads();
+
+	if (SaveTask.IsValid())
+		SaveTask.Wait();
+
+	//Callbacks and the player wait for BeginPlay, whatever happens below
+	LevelLoadWorld = World;
+	bLevelLoadHasRecords = false;
+
+	if (!LevelLoadTickHandle.IsValid())
+		LevelLoadTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USaveSubsystem::TickLevelLoad));
+
+	LastLoadTimings = FSavePhaseTimings();
+	LastLoadClassCosts.Reset();
+	double PhaseStart = FPlatformTime::Seconds();
+
+	SaveGameSlot = ReadSaveGameForLevel(SlotName, World);
+
+	LastLoadTimings.ReadSeconds = FPlatformTime::Seconds() - PhaseStart;
+
+	//FinishLevelLoad fires the callbacks of the new session once the world has begun play
+	if (SaveGameSlot == nullptr)
+	{
+		StartNewSession(World, false);
+		return;
+	}
+
+	const FSaveLevelViewPtr View = GetLevelView(World->GetFName(), false);
+	USaveObjectRegistry* Registry = World->GetSubsystem<USaveObjectRegistry>();
+
+	if (!View.IsValid() || Registry == nullptr)
+		return;
+
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_LoadMatchActors);
+
+	PhaseStart = FPlatformTime::Seconds();
+
+	//Components are not registered yet, the registry picks up the placed actors ahead of its own pass
+	for (ULevel* Level : World->GetLevels())
+	{
+		Registry->RegisterLevelActors(Level);
+	}
+
+	UpdatePlacedTransforms(World);
+
+	View->BuildIndex();
+
+	const TMap<FName, int32>& RecordIndex = View->GetIndex();
+	TBitArray<> MatchedRecords(false, View->Num());
+
+	TArray<AActor*> SaveObjects;
+	TArray<UActorComponent*> Components;
+	TArray<UActorComponent*> LoadedComponents;
+
+	Registry->GetSaveObjects(SaveObjects);
+
+	for (AActor* Actor : SaveObjects)
+	{
+		if (IsActorAPlayer(Actor) || Actor->GetLevel() != World->PersistentLevel)
+			continue;
+
+		const int32* Index = RecordIndex.Find(Actor->GetFName());
+
+		//Destroyed before the level was saved, gone before its components register or it begins play
+		if (Index == nullptr)
+		{
+			RecordDestroyedActor(Actor->GetClass());
+			Actor->Destroy();
+			continue;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		const FSaveActorView& Record = View->GetActor(*Index);
+		MatchedRecords[*Index] = true;
+
+		Registry->GetSaveComponents(Actor, Components);
+
+		Actor->SetActorTransform(GetRecordTransform(Actor, Record));
+		FSaveNameTableArchive::LoadObject(Actor, Record.BinaryData, NameTable);
+
+		TBitArray<> AppliedComponents(false, Record.NumComponents);
+		LoadedComponents.Reset();
+
+		ApplyComponentData(Components, View->GetComponents(Record), AppliedComponents, LoadedComponents);
+
+		RecordLoadedActor(Actor->GetClass(), *View, Record, FPlatformTime::Seconds() - StartTime);
+	}
+
+	LastLoadTimings.MatchSeconds = FPlatformTime::Seconds() - PhaseStart;
+	bLevelLoadHasRecords = true;
+
+	//Runtime spawned actors are respawned once the world has begun play
+	PendingRespawns.bActive = true;
+	PendingRespawns.World = World;
+	PendingRespawns.View = View;
+
+	for (int32 i = 0; i < View->Num(); i++)
+	{
+		if (!MatchedRecords[i])
+			PendingRespawns.Records.Add(i);
+	}
+
+	DirtyActors.Reset();
+}
+
+bool USaveSubsystem::TickLevelLoad(float DeltaTime)
+{
+	UWorld* World = LevelLoadWorld.Get();
+
+	if (World == nullptr)
+	{
+		LevelLoadTickHandle.Reset();
+		return false;
+	}
+
+	if (!World->HasBegunPlay())
+		return true;
+
+	LevelLoadTickHandle.Reset();
+	LevelLoadWorld.Reset();
+
+	FinishLevelLoad(World);
+
+	return false;
+}
+
+void USaveSubsystem::FinishLevelLoad(UWorld* World)
+{
+	const bool bHasLevelData = bLevelLoadHasRecords;
+	bLevelLoadHasRecords = false;
+
+	if (bHasLevelData)
+		LoadPlayer(World);
+
+	//Sublevels streamed in before play began get their state now, the callback below covers their actors as well
+	TArray<TPair<ULevel*, TArray<int32>>> StreamingRespawns;
+	ApplyStreamingLevels(World, false, StreamingRespawns);
+
+	//Every save object gets its single OnActorLoaded here, its saved state has been in place since before BeginPlay
+	InitiateOnActorLoadedCallback(World);
+
+	RespawnStreamingLevels(StreamingRespawns);
+
+	if (!bHasLevelData)
+	{
+		OnGameFullyLoaded.Broadcast(SaveGameSlot);
+		return;
+	}
+
+	OnLoadGame.Broadcast(SaveGameSlot);
+
+	StartRespawns();
+}
+
+void USaveSubsystem::StartRespawns()
+{
+	if (!bTimeSlicedRespawn || PendingRespawns.Records.Num() == 0)
+	{
+		ProcessRespawns(0.0);
+		return;
+	}
+
+	//The first batch goes out this frame, the rest from the ticker
+	if (ProcessRespawns(RespawnBudgetMs / 1000.0))
+		RespawnTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USaveSubsystem::TickRespawns));
+}
+
+bool USaveSubsystem::ProcessRespawns(double BudgetSeconds)
+{
+	FPendingRespawns& Respawns = PendingRespawns;
+
+	if (!Respawns.bActive)
+		return false;
+
+	UWorld* World = Respawns.World.Get();
+	const FSaveLevelView* View = Respawns.View.Get();
+
+	if (World == nullptr || View == nullptr)
+	{
+		CancelRespawns();
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + BudgetSeconds;
+
+	while (Respawns.NextRecord < Respawns.Records.Num())
+	{
+		const int32 Record = Respawns.Records[Respawns.NextRecord++];
+
+		if (View->IsValidIndex(Record))
+			RespawnActor(World, *View, View->GetActor(Record));
+
+		if (BudgetSeconds > 0.0 && FPlatformTime::Seconds() >= EndTime)
+			break;
+	}
+
+	LastLoadTimings.SpawnSeconds += FPlatformTime::Seconds() - StartTime;
+
+	if (Respawns.NextRecord < Respawns.Records.Num())
+		return true;
+
+	Respawns = FPendingRespawns();
+
+	OnGameFullyLoaded.Broadcast(SaveGameSlot);
+
+	return false;
+}
+
+bool USaveSubsystem::TickRespawns(float DeltaTime)
+{
+	if (ProcessRespawns(RespawnBudgetMs / 1000.0))
+		return true;
+
+	RespawnTickHandle.Reset();
+	return false;
+}
+
+void USaveSubsystem::FlushRespawns()
+{
+	if (!PendingRespawns.bActive)
+		return;
+
+	if (RespawnTickHandle.IsValid())
+		FTicker::GetCoreTicker().RemoveTicker(RespawnTickHandle);
+
+	RespawnTickHandle.Reset();
+	ProcessRespawns(0.0);
+}
+
+void USaveSubsystem::CancelRespawns()
+{
+	if (RespawnTickHandle.IsValid())
+		FTicker::GetCoreTicker().RemoveTicker(RespawnTickHandle);
+
+	RespawnTickHandle.Reset();
+	PendingRespawns = FPendingRespawns();
+}
+
+AActor* USaveSubsystem::RespawnActor(UWorld* World, const FSaveLevelView& View, const FSaveActorView& Record, ULevel* Level)
+{
+	UClass* ActorClass = Record.ActorClass;
+
+	//The class was renamed or removed since the save was made
+	if (ActorClass == nullptr)
+		return nullptr;
+
+	SCOPE_CYCLE_COUNTER(STAT_LoadSpawnActor);
+	SAVE_TRACE_CLASS_SCOPE(ActorClass);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.bDeferConstruction = true;
+	SpawnParameters.OverrideLevel = Level;
+
+	AActor* Actor = World->SpawnActor<AActor>(ActorClass, Record.Transform, SpawnParameters);
+
+	if (Actor == nullptr)
+		return nullptr;
+
+	//Only tagged actors were saved, the tag may have been added at runtime and not be on the class defaults
+	Actor->Tags.AddUnique(USaveObjectRegistry::SaveObjectTag);
+
+	const TArrayView<const FSaveComponentView> ComponentData = View.GetComponents(Record);
+
+	//Native components exist already, their state and the actor's go in before construction and BeginPlay
+	FSaveNameTableArchive::LoadObject(Actor, Record.BinaryData, NameTable);
+
+	TBitArray<> AppliedComponents(false, ComponentData.Num());
+	TArray<UActorComponent*> LoadedComponents;
+
+	ApplyComponentData(Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass()), ComponentData, AppliedComponents, LoadedComponents);
+
+	Actor->FinishSpawning(Record.Transform);
+
+	if (Actor->IsPendingKill())
+		return nullptr;
+
+	//Components added by the construction script only exist now, the registry recaches them as well
+	TArray<UActorComponent*> Components;
+
+	if (USaveObjectRegistry* Registry = World->GetSubsystem<USaveObjectRegistry>())
+	{
+		Registry->RegisterSaveObject(Actor);
+		Registry->RefreshSaveComponents(Actor);
+		Registry->GetSaveComponents(Actor, Components);
+	}
+
+	//Construction may have stripped the tag again, the components still get their records
+	if (Components.Num() == 0)
+		Components = Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass());
+
+	ApplyComponentData(Components, ComponentData, AppliedComponents, LoadedComponents);
+
+	for (UActorComponent* Component : LoadedComponents)
+	{
+		ISaveLoadActorInterface::Execute_OnActorLoaded(Component);
+	}
+
+	if (Actor->Implements<USaveLoadActorInterface>())
+		ISaveLoadActorInterface::Execute_OnActorLoaded(Actor);
+
+	FSaveClassCost& Cost = FindClassCost(LastLoadClassCosts, ActorClass);
+	Cost.Spawned++;
+	Cost.Seconds += FPlatformTime::Seconds() - StartTime;
+
+	INC_DWORD_STAT(STAT_LoadActorsSpawned);
+
+	return Actor;
+}
+
+void USaveSubsystem::ApplyComponentData(const TArray<UActorComponent*>& Components, TArrayView<const FSaveComponentView> Data, TBitArray<>& Applied, TArray<UActorComponent*>& OutLoaded)
+{
+	if (Components.Num() == 0 || Data.Num() == 0)
+		return;
+
+	const FSaveComponentLayoutRef Layout = SaveComponentLayout::Get(Components[0]->GetOwner(), Components);
+
+	for (UActorComponent* Component : Components)
+	{
+		const int32 Index = SaveComponentLayout::FindRecord(*Layout, Data, Applied, Component->GetFName());
+
+		if (Index == INDEX_NONE)
+			continue;
+
+		FSaveNameTableArchive::LoadObject(Component, Data[Index].BinaryData, NameTable);
+
+		Applied[Index] = true;
+		OutLoaded.Add(Component);
+	}
+}
+
+void USaveSubsystem::SaveGameTimeSliced(UObject* WorldContext, FString SlotName)
+{
+	//The world is about to be replaced by the load, there is nothing worth saving yet
+	if (bLoadInFlight)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Save to %s ignored while LoadGameAsync is preparing a slot"), *SlotName);
+		return;
+	}
+
+	FlushRespawns();
+
+	if (bSaveInFlight || TimeSlicedSave.bActive)
+	{
+		bSavePending = true;
+		bPendingTimeSliced = true;
+		PendingSaveSlotName = SlotName;
+		PendingSaveWorldContext = WorldContext;
+
+		return;
+	}
+
+	if (SaveGameSlot == nullptr)
+		SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
+
+	LastSaveTimings = FSavePhaseTimings();
+	LastSaveClassCosts.Reset();
+
+	double PhaseStart = FPlatformTime::Seconds();
+
+	//The player is only a few objects, it is captured whole in the first frame
+	SavePlayer(WorldContext);
+
+	LastSaveTimings.SerializeSeconds += FPlatformTime::Seconds() - PhaseStart;
+	PhaseStart = FPlatformTime::Seconds();
+
+	UWorld* World = WorldContext->GetWorld();
+
+	FTimeSlicedSave& Slice = TimeSlicedSave;
+	Slice.bActive = true;
+	Slice.SlotName = SlotName;
+	Slice.World = World;
+	Slice.LevelName = World->GetFName();
+
+	TMap<ULevel*, TArray<AActor*>> LevelActors;
+	GatherLevelActors(World, LevelActors);
+
+	//Streamed sublevels are captured whole this frame, the same way they are when they stream out
+	for (TPair<ULevel*, TArray<AActor*>>& Pair : LevelActors)
+	{
+		if (!Pair.Key->IsPersistentLevel())
+			CaptureLevel(Pair.Key, Pair.Value);
+	}
+
+	const TArray<AActor*>& SaveObjects = LevelActors.FindOrAdd(World->PersistentLevel);
+
+	Slice.Actors.Reserve(SaveObjects.Num());
+	Slice.Transforms.Reserve(SaveObjects.Num());
+
+	//Which actors exist and where they are is decided this frame, later frames only fill in their blobs
+	for (AActor* Actor : SaveObjects)
+	{
+		if (IsActorAPlayer(Actor))
+			continue;
+
+		Slice.Actors.Add(Actor);
+		Slice.Transforms.Add(Actor->GetActorTransform());
+	}
+
+	//Actors marked dirty from here on are picked up by the next save
+	Slice.FrozenDirtyActors = MoveTemp(DirtyActors);
+	DirtyActors.Reset();
+
+	FLevelSaveData* PreviousLevelData = bIncrementalSave ? FindLevelRecords(Slice.LevelName, false) : nullptr;
+
+	if (PreviousLevelData != nullptr)
+	{
+		Slice.PreviousLevelData = MoveTemp(*PreviousLevelData);
+		BuildActorRecordIndex(Slice.PreviousLevelData, Slice.PreviousIndex);
+	}
+
+	Slice.ActorSave.Reserve(Slice.Actors.Num());
+
+	LastSaveTimings.IterateSeconds += FPlatformTime::Seconds() - PhaseStart;
+
+	TimeSlicedTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USaveSubsystem::TickTimeSlicedSave));
+
+	OnSaveProgress.Broadcast(0.0f);
+}
+
+float USaveSubsystem::GetSaveProgress() const
+{
+	if (!TimeSlicedSave.bActive || TimeSlicedSave.Actors.Num() == 0)
+		return 1.0f;
+
+	return (float)TimeSlicedSave.NextActor / TimeSlicedSave.Actors.Num();
+}
+
+bool USaveSubsystem::TickTimeSlicedSave(float DeltaTime)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveTimeSlice);
+
+	FTimeSlicedSave& Slice = TimeSlicedSave;
+	UWorld* World = Slice.World.Get();
+
+	if (World == nullptr)
+	{
+		CancelTimeSlicedSave();
+		return false;
+	}
+
+	USaveObjectRegistry* Registry = World->GetSubsystem<USaveObjectRegistry>();
+	TArray<UActorComponent*> Components;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + TimeSliceBudgetMs / 1000.0;
+
+	//The budget is checked after each actor so every frame makes progress
+	while (Slice.NextActor < Slice.Actors.Num())
+	{
+		const int32 i = Slice.NextActor++;
+		AActor* Actor = Slice.Actors[i].Get();
+
+		//Destroyed after the cut, left out just like the next full save would
+		if (Actor == nullptr || Actor->IsPendingKill())
+			continue;
+
+		const int32* PreviousRecord = Slice.PreviousIndex.Find(Actor->GetFName());
+
+		INC_DWORD_STAT(STAT_SaveActorsVisited);
+
+		if (PreviousRecord != nullptr && !Slice.FrozenDirtyActors.Contains(Actor))
+		{
+			FActorSaveData& Data = Slice.PreviousLevelData.LevelActorData[*PreviousRecord];
+			Data.Transform = Slice.Transforms[i];
+
+			FindClassCost(LastSaveClassCosts, Actor->GetClass()).Actors++;
+
+			Slice.ActorSave.Add(MoveTemp(Data));
+		}
+		else
+		{
+			const double ActorStart = FPlatformTime::Seconds();
+
+			if (Registry != nullptr)
+				Registry->GetSaveComponents(Actor, Components);
+
+			FActorSaveData Data;
+			SaveActorData(Actor, Components, Data);
+			Data.Transform = Slice.Transforms[i];
+
+			RecordSavedActor(Actor->GetClass(), Data, FPlatformTime::Seconds() - ActorStart);
+
+			Slice.ActorSave.Add(MoveTemp(Data));
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime)
+			break;
+	}
+
+	LastSaveTimings.SerializeSeconds += FPlatformTime::Seconds() - StartTime;
+
+	OnSaveProgress.Broadcast(GetSaveProgress());
+
+	if (Slice.NextActor < Slice.Actors.Num())
+		return true;
+
+	TimeSlicedTickHandle.Reset();
+	FinishTimeSlicedSave();
+
+	return false;
+}
+
+void USaveSubsystem::FinishTimeSlicedSave()
+{
+	FTimeSlicedSave& Slice = TimeSlicedSave;
+
+	FLevelSaveData LevelData;
+	LevelData.LevelActorData = MoveTemp(Slice.ActorSave);
+
+	SaveGameSlot->WorldActorData.FindOrAdd(Slice.LevelName) = MoveTemp(LevelData);
+	LevelViews.Remove(Slice.LevelName);
+	DirtyLevelChunks.Add(Slice.LevelName);
+
+	const FString SlotName = Slice.SlotName;
+	UWorld* World = Slice.World.Get();
+	Slice = FTimeSlicedSave();
+
+	bTimeSlicedWriteInFlight = true;
+	WriteSaveGameAsync(SlotName);
+
+	if (World != nullptr)
+		PushSnapshot(SlotName, World);
+}
+
+void USaveSubsystem::CancelTimeSlicedSave()
+{
+	FTimeSlicedSave& Slice = TimeSlicedSave;
+
+	if (!Slice.bActive)
+		return;
+
+	if (TimeSlicedTickHandle.IsValid())
+		FTicker::GetCoreTicker().RemoveTicker(TimeSlicedTickHandle);
+
+	TimeSlicedTickHandle.Reset();
+
+	//Records captured so far win, previous records fill in the actors that were not reached yet
+	if (SaveGameSlot != nullptr && Slice.PreviousIndex.Num() > 0)
+	{
+		TSet<FName> CapturedNames;
+
+		for (const FActorSaveData& Data : Slice.ActorSave)
+		{
+			CapturedNames.Add(Data.ActorName);
+		}
+
+		for (FActorSaveData& Data : Slice.PreviousLevelData.LevelActorData)
+		{
+			if (!CapturedNames.Contains(Data.ActorName))
+				Slice.ActorSave.Add(MoveTemp(Data));
+		}
+
+		FLevelSaveData LevelData;
+		LevelData.LevelActorData = MoveTemp(Slice.ActorSave);
+
+		SaveGameSlot->WorldActorData.FindOrAdd(Slice.LevelName) = MoveTemp(LevelData);
+	}
+
+	DirtyActors.Append(Slice.FrozenDirtyActors);
+
+	Slice = FTimeSlicedSave();
+}
+
+void USaveSubsystem::WaitForPendingSave()
+{
+	FlushRespawns();
+
+	//The write posts its result to the game thread, pump it until every write including coalesced ones is done
+	while (bSaveInFlight || TimeSlicedSave.bActive)
+	{
+		//Finish a time sliced capture right away, there is no frame left to spread it over
+		if (TimeSlicedSave.bActive)
+		{
+			if (TimeSlicedTickHandle.IsValid())
+				FTicker::GetCoreTicker().RemoveTicker(TimeSlicedTickHandle);
+
+			TimeSlicedTickHandle.Reset();
+
+			while (TimeSlicedSave.bActive && TickTimeSlicedSave(0.0f))
+			{
+			}
+
+			continue;
+		}
+
+		if (SaveTask.IsValid())
+			SaveTask.Wait();
+
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	}
+}
+
+void USaveSubsystem::MarkActorDirty(AActor* Actor)
+{
+	if (Actor == nullptr)
+		return;
+
+	DirtyActors.Add(Actor);
+
+	if (bJournalSave)
+		QueueJournal(Actor, false);
+}
+
+USaveSubsystem* USaveSubsystem::Get(const UObject* WorldContext)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull);
+	UGameInstance* GameInstance = World != nullptr ? World->GetGameInstance() : nullptr;
+
+	return GameInstance != nullptr ? GameInstance->GetSubsystem<USaveSubsystem>() : nullptr;
+}
+
+void USaveSubsystem::MarkSaveDirty(UObject* Object)
+{
+	if (Object == nullptr)
+		return;
+
+	AActor* Owner = Cast<AActor>(Object);
+
+	if (Owner == nullptr)
+	{
+		UActorComponent* Component = Cast<UActorComponent>(Object);
+		Owner = Component != nullptr ? Component->GetOwner() : Object->GetTypedOuter<AActor>();
+	}
+
+	USaveSubsystem* SaveSubsystem = Get(Owner);
+
+	if (SaveSubsystem != nullptr)
+		SaveSubsystem->MarkActorDirty(Owner);
+}
+
+void USaveSubsystem::MarkSaveDestroyed(AActor* Actor)
+{
+	USaveSubsystem* SaveSubsystem = Get(Actor);
+
+	if (SaveSubsystem == nullptr)
+		return;
+
+	SaveSubsystem->DirtyActors.Add(Actor);
+
+	if (SaveSubsystem->bJournalSave)
+		SaveSubsystem->QueueJournal(Actor, true);
+}
+
+void USaveSubsystem::FlushJournal()
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveJournalFlush);
+
+	//Records can't change while a write or a time sliced save reads them, the ticker tries again later
+	if (JournalQueue.Num() == 0 || SaveGameSlot == nullptr || !Journal.IsOpen() || bSaveInFlight || TimeSlicedSave.bActive)
+		return;
+
+	//The respawn queue reads the records changed below
+	FlushRespawns();
+
+	TArray<FSaveJournalEntry> Entries;
+	Entries.Reserve(JournalQueue.Num());
+
+	TArray<UActorComponent*> Components;
+
+	for (const TPair<TObjectKey<AActor>, FJournalTarget>& Pair : JournalQueue)
+	{
+		const FJournalTarget& Target = Pair.Value;
+		AActor* Actor = Target.Actor.Get();
+
+		//Actors that are gone without being destroyed were streamed out, their last record stays
+		if (Actor == nullptr && !Target.bDestroyed)
+			continue;
+
+		if (Target.bPlayer)
+		{
+			if (Target.bDestroyed)
+				continue;
+
+			SavePlayer(Actor);
+
+			FSaveJournalEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Op = ESaveJournalOp::Player;
+			Entry.PlayerData = SaveGameSlot->PlayerData;
+
+			continue;
+		}
+
+		//A lone record in a level that was never saved would read as every other actor of it being destroyed
+		FLevelSaveData* LevelData = FindLevelRecords(Target.LevelName, false);
+
+		if (LevelData == nullptr)
+			continue;
+
+		const int32 RecordIndex = LevelData->LevelActorData.IndexOfByPredicate([&](const FActorSaveData& Data)
+			{
+				return Data.ActorName == Target.ActorName;
+			});
+
+		FSaveJournalEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.LevelName = Target.LevelName;
+
+		if (Target.bDestroyed)
+		{
+			Entry.Op = ESaveJournalOp::ActorRemoved;
+			Entry.Record.ActorName = Target.ActorName;
+
+			if (RecordIndex != INDEX_NONE)
+				LevelData->LevelActorData.RemoveAtSwap(RecordIndex);
+		}
+		else
+		{
+			USaveObjectRegistry* Registry = Actor->GetWorld()->GetSubsystem<USaveObjectRegistry>();
+
+			if (Registry != nullptr)
+				Registry->GetSaveComponents(Actor, Components);
+			else
+				Components.Reset();
+
+			Entry.Op = ESaveJournalOp::ActorRecord;
+			SaveActorData(Actor, Components, Entry.Record);
+
+			if (RecordIndex != INDEX_NONE)
+				LevelData->LevelActorData[RecordIndex] = Entry.Record;
+			else
+				LevelData->LevelActorData.Add(Entry.Record);
+		}
+
+		//The record in SaveGameSlot is current now, the next write carries it into the chunk
+		DirtyLevelChunks.Add(Target.LevelName);
+	}
+
+	JournalQueue.Reset();
+
+	if (Entries.Num() == 0)
+		return;
+
+	TArray<uint8> Batch;
+	int64 Offset = 0;
+
+	Journal.EncodeBatch(Entries, NameTable, Batch, Offset);
+
+	//Batches have to land in order, the previous one is long done at any reasonable flush interval
+	WaitForJournal();
+
+	const FString JournalPath = Journal.GetPath();
+
+	JournalTask = Async(EAsyncExecution::ThreadPool, [JournalPath, Offset, Batch = MoveTemp(Batch)]()
+		{
+			FSaveJournal::AppendBatch(JournalPath, Offset, Batch);
+		});
+}
+
+void USaveSubsystem::QueueJournal(AActor* Actor, bool bDestroyed)
+{
+	UWorld* World = Actor->GetWorld();
+
+	if (!Journal.IsOpen() || World == nullptr)
+		return;
+
+	FJournalTarget& Target = JournalQueue.FindOrAdd(Actor);
+	Target.Actor = Actor;
+	Target.LevelName = GetLevelSaveName(Actor->GetLevel());
+	Target.ActorName = Actor->GetFName();
+	Target.bPlayer = IsActorAPlayer(Actor);
+	Target.bDestroyed |= bDestroyed;
+
+	if (!JournalTickHandle.IsValid())
+		JournalTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USaveSubsystem::TickJournal), JournalFlushInterval);
+}
+
+bool USaveSubsystem::TickJournal(float DeltaTime)
+{
+	//Waits for the respawns as well, flushing would finish them in a single frame
+	if (bSaveInFlight || TimeSlicedSave.bActive || PendingRespawns.bActive)
+		return true;
+
+	FlushJournal();
+	JournalTickHandle.Reset();
+
+	//The slot catches up with the journal in the background, the journal then starts over against the new snapshot
+	if (Journal.IsOpen() && Journal.GetSize() >= (int64)JournalCompactKB * 1024 && SaveGameSlot != nullptr)
+		WriteSaveGameAsync(Journal.GetSlotName());
+
+	return false;
+}
+
+void USaveSubsystem::WaitForJournal()
+{
+	if (JournalTask.IsValid())
+		JournalTask.Wait();
+}
+
+void USaveSubsystem::CloseJournal()
+{
+	WaitForJournal();
+
+	JournalQueue.Reset();
+	Journal.Close();
+}
+
+void USaveSubsystem::PushSnapshot(const FString& SlotName, UWorld* World)
+{
+	if (MaxSnapshots <= 0 || !SaveGameSlot->WorldActorData.Contains(World->GetFName()))
+		return;
+
+	//The worker serializes a copy of the records taken when the save started, SaveGameSlot is the game thread's alone while it writes
+	FSaveSnapshot& Snapshot = Snapshots.AddDefaulted_GetRef();
+	Snapshot.SlotName = SlotName;
+	Snapshot.SlotTicks = LastWriteTicks;
+	Snapshot.LevelName = World->GetFName();
+	Snapshot.PlayerData = SaveGameSlot->PlayerData;
+
+	//The persistent level and every sublevel the save just captured
+	for (ULevel* Level : World->GetLevels())
+	{
+		const FName LevelName = GetLevelSaveName(Level);
+
+		if (const FLevelSaveData* LevelData = SaveGameSlot->WorldActorData.Find(LevelName))
+			Snapshot.Levels.Add(LevelName, *LevelData);
+	}
+
+	Snapshot.Bytes = SaveSubsystemSnapshot::GetSnapshotBytes(Snapshot.Levels, Snapshot.PlayerData);
+
+	SnapshotBytes += Snapshot.Bytes;
+
+	const int64 MaxBytes = (int64)SnapshotMemoryCapKB * 1024;
+
+	//Oldest first, a single snapshot over the cap is dropped as well
+	while (Snapshots.Num() > 0 && (Snapshots.Num() > MaxSnapshots || SnapshotBytes > MaxBytes))
+	{
+		SnapshotBytes -= Snapshots[0].Bytes;
+		Snapshots.RemoveAt(0);
+	}
+}
+
+bool USaveSubsystem::RestoreSnapshot(UObject* WorldContext, int32 Age)
+{
+	UWorld* World = WorldContext != nullptr ? WorldContext->GetWorld() : nullptr;
+	const int32 SnapshotIndex = Snapshots.Num() - 1 - Age;
+
+	if (World == nullptr || SaveGameSlot == nullptr || !Snapshots.IsValidIndex(SnapshotIndex) || Snapshots[SnapshotIndex].LevelName != World->GetFName())
+		return false;
+
+	CancelPendingLoads();
+
+	//A write in flight has its own copy of the records, they are swapped right away.
+	//Sublevels the restore applies are loaded and captured in the snapshot, nothing is read from the slot being written
+
+	const FSaveSnapshot& Snapshot = Snapshots[SnapshotIndex];
+
+	//The slot on disk is exactly this snapshot as long as no later write happened, an empty journal makes loading it agree with the world.
+	//Otherwise the slot keeps the later state until the next save writes the restored level
+	if (Journal.IsOpen() && Journal.GetSlotName() == Snapshot.SlotName && Journal.GetSnapshotTicks() == Snapshot.SlotTicks)
+	{
+		CloseJournal();
+		Journal.Start(Snapshot.SlotName, Snapshot.SlotTicks);
+	}
+	else
+	{
+		JournalQueue.Reset();
+	}
+
+	LastLoadTimings = FSavePhaseTimings();
+	LastLoadClassCosts.Reset();
+
+	//Copied, so a retry after the next death can restore the same snapshot again
+	for (const TPair<FName, FLevelSaveData>& Pair : Snapshot.Levels)
+	{
+		SaveGameSlot->WorldActorData.FindOrAdd(Pair.Key) = Pair.Value;
+		StreamedLevelRecords.Remove(Pair.Key);
+		LevelViews.Remove(Pair.Key);
+
+		//Snapshots are taken of loaded levels, their transforms are complete
+		if (FSavePlacedTransforms* Placed = PlacedTransforms.Find(Pair.Key))
+			Placed->UnresolvedParts.Reset();
+
+		DirtyLevelChunks.Add(Pair.Key);
+	}
+
+	SaveGameSlot->PlayerData = Snapshot.PlayerData;
+
+	ApplyLoadedLevel(WorldContext);
+
+	return true;
+}
+
+void USaveSubsystem::ClearSnapshots()
+{
+	Snapshots.Reset();
+	SnapshotBytes = 0;
+}
+
+FName USaveSubsystem::GetLastSaveLevel(FString SlotName, bool& HasSave)
+{
+	FSaveSlotInfo SlotInfo;
+	HasSave = GetSaveSlotInfo(SlotName, SlotInfo);
+
+	return SlotInfo.LevelName;
+}
+
+bool USaveSubsystem::GetSaveSlotInfo(FString SlotName, FSaveSlotInfo& OutInfo)
+{
+	if (FSaveSlotFile::ReadSlotInfo(SlotName, OutInfo))
+		return true;
+
+	//Slots from before the chunked layout have to be read in full, they are rewritten with a header on the next save
+	UMainSaveGame* LegacySaveGame = Cast<UMainSaveGame>(SaveSubsystemFile::LoadSaveGameFromSlot(SlotName, 0));
+
+	if (LegacySaveGame == nullptr)
+		return false;
+
+	OutInfo = FSaveSlotInfo();
+	OutInfo.SlotName = SlotName;
+	OutInfo.LevelName = LegacySaveGame->PlayerData.CurrentLevel;
+	OutInfo.PlayerTransform = LegacySaveGame->PlayerData.PlayerTransform;
+	OutInfo.Timestamp = IFileManager::Get().GetTimeStamp(*FSaveSlotFile::GetSlotPath(SlotName));
+
+	return true;
+}
+
+TArray<FSaveSlotInfo> USaveSubsystem::GetSaveSlots()
+{
+	TArray<FString> SlotNames;
+	FSaveSlotFile::FindSlotNames(SlotNames);
+
+	TArray<FSaveSlotInfo> Slots;
+	Slots.Reserve(SlotNames.Num());
+
+	for (const FString& SlotName : SlotNames)
+	{
+		FSaveSlotInfo SlotInfo;
+
+		if (GetSaveSlotInfo(SlotName, SlotInfo))
+			Slots.Add(SlotInfo);
+	}
+
+	//Newest first, the order slot menus show them in
+	Slots.Sort([](const FSaveSlotInfo& A, const FSaveSlotInfo& B)
+		{
+			return A.Timestamp > B.Timestamp;
+		});
+
+	return Slots;
+}
+
+float USaveSubsystem::GetPlayTimeSeconds() const
+{
+	return (float)(PlayTimeBase + FPlatformTime::Seconds() - PlayTimeStart);
+}
+
+void USaveSubsystem::WriteSaveGameAsync(const FString& SlotName)
+{
+	//Journaled changes not appended yet go straight into this write
+	FlushJournal();
+
+	//The prefetched bytes are about to be out of date
+	if (Prefetch.IsValid() && Prefetch->GetSlotName() == SlotName)
+		CancelPrefetch();
+
+	bSaveInFlight = true;
+	InFlightSaveGame = SaveGameSlot;
+
+	FSaveNameTable* WriteNameTable = &NameTable;
+	TWeakObjectPtr<USaveSubsystem> WeakThis(this);
+
+	//Only the player chunk and the levels captured since the last write are rewritten
+	TArray<FName> Levels = DirtyLevelChunks.Array();
+	DirtyLevelChunks.Reset();
+
+	//The worker writes a copy, the save object stays free to change while the slot is written
+	TSharedRef<SaveSubsystemFile::FWriteRecords, ESPMode::ThreadSafe> Records = MakeShared<SaveSubsystemFile::FWriteRecords, ESPMode::ThreadSafe>();
+	Records->PlayerData = SaveGameSlot->PlayerData;
+	Records->Levels.Reserve(Levels.Num());
+
+	for (const FName& Level : Levels)
+	{
+		const FLevelSaveData* LevelData = SaveGameSlot->WorldActorData.Find(Level);
+
+		if (LevelData != nullptr)
+			Records->Levels.Emplace(Level, *LevelData);
+
+		if (const FSavePlacedTransforms* Placed = PlacedTransforms.Find(Level))
+			Records->PlacedTransforms.Add(Level, *Placed);
+	}
+
+	const FString SourceSlotName = LoadedSlotName;
+	const int32 WriteSessionId = SessionId;
+
+	//Summary for slot menus, written into the fixed size header next to the TOC pointer
+	FSaveSlotInfo SlotInfo;
+	SlotInfo.SlotName = SlotName;
+	SlotInfo.LevelName = SaveGameSlot->PlayerData.CurrentLevel;
+	SlotInfo.PlayerTransform = SaveGameSlot->PlayerData.PlayerTransform;
+	SlotInfo.PlayTimeSeconds = GetPlayTimeSeconds();
+	SlotInfo.Timestamp = FDateTime::UtcNow();
+
+	LastWriteTicks = SlotInfo.Timestamp.GetTicks();
+
+	//Everything journaled so far is part of this snapshot. The new journal goes into a file of its own, the one of the snapshot on disk
+	//stays until the write has landed. When the write fails the slot keeps its old timestamp and its journal, the new one is ignored on load
+	WaitForJournal();
+
+	if (bJournalSave)
+		Journal.Start(SlotName, SlotInfo.Timestamp.GetTicks());
+	else
+		Journal.Close();
+
+	FSaveBlobPool* Pool = bPoolSaveBlobs ? &BlobPool : nullptr;
+
+	const ESaveChunkCodec Codec = SaveCodec;
+	const bool bParallel = bParallelCompression;
+
+	SaveTask = Async(EAsyncExecution::ThreadPool, [WeakThis, Records, WriteNameTable, Pool, SlotName, SourceSlotName, WriteSessionId, Levels, SlotInfo, Codec, bParallel]()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+
+			//A pool this build can't read is left alone, the chunks keep their blobs inline
+			FSaveBlobPool* LevelPool = Pool != nullptr && Pool->Open() ? Pool : nullptr;
+
+			TArray<FSaveChunkData> Chunks;
+			Chunks.Reserve(Records->Levels.Num() + 2);
+
+			//Serialized raw first, the name table and the pool are filled in order and only the compression runs in parallel
+			FSaveSlotFile::BuildPlayerChunk(Records->PlayerData, *WriteNameTable, Chunks.AddDefaulted_GetRef(), ESaveChunkCodec::None);
+
+			for (TPair<FName, FLevelSaveData>& Level : Records->Levels)
+			{
+				FSaveSlotFile::BuildLevelChunk(Level.Key, Level.Value, *WriteNameTable, LevelPool, Chunks.AddDefaulted_GetRef(), ESaveChunkCodec::None, Records->PlacedTransforms.Find(Level.Key));
+			}
+
+			//Written last so it contains every name the chunks above added
+			FSaveSlotFile::BuildNameTableChunk(*WriteNameTable, Chunks.AddDefaulted_GetRef(), ESaveChunkCodec::None);
+
+			int64 BytesUncompressed = 0;
+
+			for (const FSaveChunkData& Chunk : Chunks)
+			{
+				BytesUncompressed += Chunk.Data.Num();
+			}
+
+			const double CompressStart = FPlatformTime::Seconds();
+			const double CompressWorkerSeconds = FSaveSlotFile::CompressChunks(Chunks, Codec, bParallel);
+			const double CompressSeconds = FPlatformTime::Seconds() - CompressStart;
+
+			//New blobs have to be on disk before a slot references them
+			const bool bSuccess = (LevelPool == nullptr || LevelPool->Flush(Codec)) && FSaveSlotFile::WriteChunks(SlotName, SourceSlotName, Chunks, SlotInfo);
+
+			//The slot now follows the new snapshot, the journals of older ones can't apply to it anymore
+			if (bSuccess)
+				FSaveJournal::DeleteOtherJournals(SlotName, SlotInfo.Timestamp.GetTicks());
+
+			if (bSuccess && LevelPool != nullptr && LevelPool->ShouldCompact())
+				LevelPool->Compact(Codec);
+
+			int64 BytesWritten = 0;
+
+			for (const FSaveChunkData& Chunk : Chunks)
+			{
+				BytesWritten += Chunk.Data.Num();
+			}
+
+			const double WriteSeconds = FPlatformTime::Seconds() - StartTime;
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, bSuccess, SlotName, Levels, WriteSessionId, WriteSeconds, BytesWritten, BytesUncompressed, CompressSeconds, CompressWorkerSeconds]()
+				{
+					if (!WeakThis.IsValid())
+						return;
+
+					WeakThis->LastSaveTimings.WriteSeconds = WriteSeconds;
+					WeakThis->LastSaveTimings.BytesWritten = BytesWritten;
+					WeakThis->LastSaveTimings.BytesUncompressed = BytesUncompressed;
+					WeakThis->LastSaveTimings.CompressSeconds = CompressSeconds;
+					WeakThis->LastSaveTimings.CompressWorkerSeconds = CompressWorkerSeconds;
+					WeakThis->OnSaveWriteFinished(bSuccess, SlotName, Levels, WriteSessionId);
+				});
+		});
+}
+
+void USaveSubsystem::OnSaveWriteFinished(bool bSuccess, const FString& SlotName, const TArray<FName>& Levels, int32 WriteSessionId)
+{
+	UMainSaveGame* WrittenSaveGame = InFlightSaveGame;
+
+	bSaveInFlight = false;
+	InFlightSaveGame = nullptr;
+
+	//Sublevels that streamed out during the write, their chunks are already marked dirty
+	for (TPair<FName, FLevelSaveData>& Pair : StreamedLevelRecords)
+	{
+		SaveGameSlot->WorldActorData.FindOrAdd(Pair.Key) = MoveTemp(Pair.Value);
+	}
+
+	StreamedLevelRecords.Reset();
+
+	//The slot on disk now holds every level of this session, later saves only append to it.
+	//A load or new game since the write started brought its own slot, the written one is not part of it
+	if (WriteSessionId == SessionId)
+	{
+		if (bSuccess)
+			LoadedSlotName = SlotName;
+		else
+			DirtyLevelChunks.Append(Levels);
+	}
+
+	//Sublevels that streamed in during the write read their records now that the slot is settled, before a coalesced save captures them
+	TArray<TWeakObjectPtr<ULevel>> DeferredLevels = MoveTemp(DeferredStreamingLevels);
+
+	for (const TWeakObjectPtr<ULevel>& Level : DeferredLevels)
+	{
+		if (Level.IsValid())
+			LoadStreamingLevel(Level.Get());
+	}
+
+	if (!bSuccess)
+		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Failed to Save Game");
+
+	OnSaveGame.Broadcast(WrittenSaveGame);
+	OnSaveGameFinished.Broadcast(WrittenSaveGame, bSuccess);
+
+	if (bTimeSlicedWriteInFlight)
+	{
+		bTimeSlicedWriteInFlight = false;
+		OnTimeSlicedSaveComplete.Broadcast(WrittenSaveGame, bSuccess);
+	}
+
+	if (!bSavePending)
+		return;
+
+	//Run the coalesced request with the latest world state
+	bSavePending = false;
+	UObject* WorldContext = PendingSaveWorldContext.Get();
+	PendingSaveWorldContext.Reset();
+
+	if (WorldContext == nullptr)
+		return;
+
+	if (bPendingTimeSliced)
+		SaveGameTimeSliced(WorldContext, PendingSaveSlotName);
+	else
+		SaveGame(WorldContext, PendingSaveSlotName);
+}
+
+void USaveSubsystem::PrefetchSlot(FString SlotName)
+{
+	if (Prefetch.IsValid() && Prefetch->GetSlotName() == SlotName && !Prefetch->IsCancelled())
+		return;
+
+	CancelPrefetch();
+
+	if (SlotName.IsEmpty())
+		return;
+
+	Prefetch = FSaveSlotPrefetch::Start(SlotName, BlobPool.GetPath(), (int64)PrefetchMemoryCapKB * 1024);
+}
+
+FString USaveSubsystem::PrefetchLatestSlot()
+{
+	TArray<FSaveSlotInfo> Slots = GetSaveSlots();
+
+	if (Slots.Num() == 0)
+		return FString();
+
+	PrefetchSlot(Slots[0].SlotName);
+	return Slots[0].SlotName;
+}
+
+void USaveSubsystem::CancelPrefetch()
+{
+	if (Prefetch.IsValid())
+		Prefetch->Cancel();
+
+	Prefetch.Reset();
+}
+
+int64 USaveSubsystem::GetPrefetchBytes() const
+{
+	return Prefetch.IsValid() ? Prefetch->GetAllocatedSize() : 0;
+}
+
+FSaveSlotPrefetchPtr USaveSubsystem::TakePrefetch(const FString& SlotName)
+{
+	FSaveSlotPrefetchPtr Taken;
+
+	if (Prefetch.IsValid() && Prefetch->GetSlotName() == SlotName)
+		Swap(Taken, Prefetch);
+
+	CancelPrefetch();
+
+	return Taken;
+}
+
+UMainSaveGame* USaveSubsystem::ReadSaveGameForLevel(const FString& SlotName, UWorld* World)
+{
+	ResetLoadedSession();
+
+	FPreparedLoad Load;
+	Load.SlotName = SlotName;
+	Load.LevelName = World->GetFName();
+	Load.Prefetch = TakePrefetch(SlotName);
+
+	GetLoadedLevelNames(World, Load.LevelNames);
+
+	UpdatePlacedTransforms(World);
+	Load.PlacedTransforms = PlacedTransforms;
+
+	PrepareLoad(Load, &BlobPool);
+
+	return Load.bChunked ? AdoptPreparedLoad(Load) : ReadLegacySaveGame(SlotName);
+}
+
+void USaveSubsystem::ResetLoadedSession()
+{
+	//Only a chunked slot that was read completely picks a journal up again, legacy slots get one after their next save
+	CloseJournal();
+
+	//Snapshots and parked sublevels belong to the session the slot replaces
+	ClearSnapshots();
+	StreamedLevelRecords.Reset();
+	LevelViews.Reset();
+
+	//The load applies every loaded sublevel itself
+	DeferredStreamingLevels.Reset();
+
+	for (TPair<FName, FSavePlacedTransforms>& Pair : PlacedTransforms)
+	{
+		Pair.Value.UnresolvedParts.Reset();
+	}
+
+	//Until a slot is adopted or written nothing is on disk for this session, the next save writes every level it captured
+	LoadedSlotName.Empty();
+	DirtyLevelChunks.Reset();
+	++SessionId;
+}
+
+void USaveSubsystem::StartNewSession(UObject* WorldContext, bool bNotify)
+{
+	SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
+	NameTable.Reset();
+	ResetLoadedSession();
+
+	//A new game starts counting play time from zero
+	PlayTimeBase = 0.0;
+	PlayTimeStart = FPlatformTime::Seconds();
+
+	if (!bNotify)
+		return;
+
+	InitiateOnActorLoadedCallback(WorldContext);
+	OnGameFullyLoaded.Broadcast(SaveGameSlot);
+}
+
+void USaveSubsystem::GetLoadedLevelNames(UWorld* World, TArray<FName>& OutLevelNames)
+{
+	//Persistent level first, it is the one LevelName refers to
+	OutLevelNames.Add(World->GetFName());
+
+	for (ULevel* Level : World->GetLevels())
+	{
+		if (!Level->IsPersistentLevel())
+			OutLevelNames.Add(GetLevelSaveName(Level));
+	}
+}
+
+void USaveSubsystem::UpdatePlacedTransforms(ULevel* Level)
+{
+	USaveObjectRegistry* Registry = Level != nullptr ? Level->OwningWorld->GetSubsystem<USaveObjectRegistry>() : nullptr;
+
+	if (Registry == nullptr)
+		return;
+
+	const FName LevelName = GetLevelSaveName(Level);
+
+	FSavePlacedTransforms& Placed = PlacedTransforms.FindOrAdd(LevelName);
+	Registry->GetPlacedTransforms(Level, Placed.Transforms);
+
+	if (Placed.UnresolvedParts.Num() == 0)
+		return;
+
+	//Records copied out of a chunk while the level was not loaded still hold placeholders for these parts
+	FLevelSaveData* LevelRecords[] = { StreamedLevelRecords.Find(LevelName), SaveGameSlot != nullptr ? SaveGameSlot->WorldActorData.Find(LevelName) : nullptr };
+
+	for (FLevelSaveData* LevelData : LevelRecords)
+	{
+		if (LevelData == nullptr)
+			continue;
+
+		for (FActorSaveData& Record : LevelData->LevelActorData)
+		{
+			const uint8* Parts = Placed.UnresolvedParts.Find(Record.ActorName);
+			const FTransform* Transform = Placed.Transforms.Find(Record.ActorName);
 
-void USaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
-{
-	Super::Initialize(Collection);
-}
+			if (Parts != nullptr && Transform != nullptr)
+				SaveTransformParts::Copy(Record.Transform, *Transform, *Parts);
+		}
+	}
 
+	//Views keep their placed parts, they are resolved when they are copied out or applied.
+	//Actors the level no longer places keep theirs, so they are still not written as values
+	for (TMap<FName, uint8>::TIterator It = Placed.UnresolvedParts.CreateIterator(); It; ++It)
+	{
+		if (Placed.Transforms.Contains(It.Key()))
+			It.RemoveCurrent();
+	}
+}
 
-void USaveSubsystem::Deinitialize()
+void USaveSubsystem::UpdatePlacedTransforms(UWorld* World)
 {
-	Super::Deinitialize();
+	for (ULevel* Level : World->GetLevels())
+	{
+		UpdatePlacedTransforms(Level);
+	}
 }
 
-void USaveSubsystem::SaveGame(UObject* WorldContext, FString SlotName)
+FTransform USaveSubsystem::GetRecordTransform(AActor* Actor, const FSaveActorView& Record)
 {
-	if (SaveGameSlot == nullptr)
-		SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
-
-	SavePlayer(WorldContext);
+	FTransform Transform = Record.Transform;
 
-	TArray<FActorSaveData> ActorSave;
+	if (Record.PlacedParts == 0)
+		return Transform;
 
-	UWorld* World = WorldContext->GetWorld();
+	USaveObjectRegistry* Registry = USaveObjectRegistry::Get(Actor);
+	const FTransform* Placed = Registry != nullptr ? Registry->FindPlacedTransform(Actor) : nullptr;
 
-	for (FActorIterator It(World); It; ++It)
-	{
-		AActor* Actor = *It;
+	if (Placed != nullptr)
+		SaveTransformParts::Copy(Transform, *Placed, Record.PlacedParts);
 
-		if(Actor->IsPendingKill() || !Actor->ActorHasTag(TEXT("SaveObject")) 
-			|| IsActorAPlayer(Actor))
-			continue;
+	return Transform;
+}
 
-		if (Actor->Implements<USaveLoadActorInterface>())
-			ISaveLoadActorInterface::Execute_OnActorSave(Actor);
+void USaveSubsystem::PrepareLoad(FPreparedLoad& Load, FSaveBlobPool* Pool)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_LoadReadSlot);
 
-		FActorSaveData Data;
-		Data.ActorClass = Actor->GetClass();
-		Data.ActorName = Actor->GetFName();
-		Data.Transform = Actor->GetActorTransform();
-		Data.ComponentsSaveData = SaveComponentData(Actor);
+	const double StartTime = FPlatformTime::Seconds();
 
-		FMemoryWriter Writer(Data.BinaryData);
-		FObjectAndNameAsStringProxyArchive Ar(Writer, true);
+	FSaveSlotFile SlotFile;
 
-		Ar.ArIsSaveGame = true;
+	//A prefetch still reading is waited for, it is already doing the reads this would start over
+	const bool bPrefetched = Load.Prefetch.IsValid() && Load.Prefetch->GetSlotFile(SlotFile);
 
-		Actor->Serialize(Ar);
-		ActorSave.Add(Data);
-	}
+	//The journal and pool of a prefetch are only used together with its slot
+	if (!bPrefetched)
+		Load.Prefetch.Reset();
 
-	FLevelSaveData LevelData;
-	LevelData.LevelActorData = ActorSave;
+	if (!bPrefetched && !SlotFile.Open(Load.SlotName))
+		return;
 
-	if (!SaveGameSlot->WorldActorData.Contains(World->GetFName()))
-		SaveGameSlot->WorldActorData.Add(World->GetFName(), LevelData);
-	else
-		SaveGameSlot->WorldActorData[World->GetFName()] = LevelData;
+	Load.bChunked = true;
+	Load.SlotInfo = SlotFile.GetInfo();
 
-	if (!UGameplayStatics::SaveGameToSlot(SaveGameSlot, SlotName, 0))
+	if (!SlotFile.ReadNameTableChunk(Load.NameTable) || !SlotFile.ReadPlayerChunk(Load.PlayerData, Load.NameTable))
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 10, FColor::Red, "Failed to Save Game");
+		Load.Prefetch.Reset();
 		return;
 	}
 
-	OnSaveGame.Broadcast(SaveGameSlot);
-}
+	//Blobs missing from the prefetched pool are read from its file, it is the same file as long as it is handed out
+	const FSaveBlobPool* PrefetchedPool = Load.Prefetch.IsValid() ? Load.Prefetch->GetBlobPool() : nullptr;
+	const FSaveBlobPool* LevelPool = PrefetchedPool != nullptr ? PrefetchedPool : Pool != nullptr && Pool->Open() ? Pool : nullptr;
 
-void USaveSubsystem::LoadGame(UObject* WorldContext, FString SlotName)
-{
-	if (!UGameplayStatics::DoesSaveGameExist(SlotName, 0))
+	//Only the chunks of the loaded levels are read, every other level stays on disk until it is loaded
+	for (const FName& LevelName : Load.LevelNames)
 	{
-		SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
-		InitiateOnActorLoadedCallback(WorldContext);
+		FSaveLevelViewPtr View = MakeShared<FSaveLevelView, ESPMode::ThreadSafe>();
 
-		return;
+		//Classes are only loaded by AdoptPreparedLoad, loading objects is not safe off the game thread
+		if (SlotFile.ReadLevelView(LevelName, *View, Load.NameTable, LevelPool, &Load.PlacedTransforms.FindOrAdd(LevelName), true))
+			Load.LevelViews.Add(LevelName, View);
 	}
 
-	SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::LoadGameFromSlot(SlotName, 0));
-	UWorld* World = WorldContext->GetWorld();
+	//Changes journaled after the slot was last written are applied on top of it
+	ReplayJournal(Load, SlotFile, LevelPool);
 
-	//If there are no save data for this level then we just call the OnActorLoaded Interface
-	if (!SaveGameSlot->WorldActorData.Contains(World->GetFName()))
+	Load.Prefetch.Reset();
+
+	if (Load.bIndexRecords)
 	{
-		InitiateOnActorLoadedCallback(WorldContext);
-		return;
+		if (const FSaveLevelViewPtr* View = Load.LevelViews.Find(Load.LevelName))
+			(*View)->BuildIndex();
 	}
 
-	LoadPlayer(WorldContext);
+	Load.bSuccess = true;
+	Load.ReadSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+void USaveSubsystem::ReplayJournal(FPreparedLoad& Load, const FSaveSlotFile& SlotFile, const FSaveBlobPool* Pool)
+{
+	TArray<FSaveJournalEntry> Entries;
 
-	FLevelSaveData LevelData = SaveGameSlot->WorldActorData[World->GetFName()];
-	TArray<FActorSaveData> SpawnData;
+	const TArray<uint8>* PrefetchedJournal = Load.Prefetch.IsValid() ? Load.Prefetch->GetJournal() : nullptr;
 
-	for (FActorIterator It(World); It; ++It)
-	{
-		AActor* Actor = *It;
-		bool IsDestroyed = true;
+	if (!Load.Journal.Resume(Load.SlotName, Load.SlotInfo.Timestamp.GetTicks(), Load.NameTable, Entries, true, PrefetchedJournal))
+		return;
 
-		if (!Actor->ActorHasTag(FName("SaveObject")) || IsActorAPlayer(Actor))
+	for (FSaveJournalEntry& Entry : Entries)
+	{
+		if (Entry.Op == ESaveJournalOp::Player)
+		{
+			Load.PlayerData = MoveTemp(Entry.PlayerData);
 			continue;
+		}
 
-		//Load data to all placed actors in world
-		for (FActorSaveData ActorData : LevelData.LevelActorData)
+		FLevelSaveData* LevelData = Load.Levels.Find(Entry.LevelName);
+		TArray<int32>* ClassPaths = Load.LevelClassPaths.Find(Entry.LevelName);
+
+		//Changed levels are copied out of their view, other levels are read as well so the next write carries their journaled changes into the slot
+		if (LevelData == nullptr)
 		{
-			if (Actor->GetFName() == ActorData.ActorName)
+			FLevelSaveData ChunkData;
+			TArray<int32> ChunkClassPaths;
+			FSaveLevelViewPtr View;
+
+			if (Load.LevelViews.RemoveAndCopyValue(Entry.LevelName, View))
 			{
-				Actor->SetActorTransform(ActorData.Transform);
-				
-				FMemoryReader Reader(ActorData.BinaryData);
+				View->Materialize(ChunkData, &Load.PlacedTransforms.FindOrAdd(Entry.LevelName));
 
-				FObjectAndNameAsStringProxyArchive Ar(Reader, true);
-				Ar.ArIsSaveGame= true;
+				for (int32 i = 0; i < View->Num(); i++)
+				{
+					ChunkClassPaths.Add(View->GetActor(i).ActorClassPath);
+				}
+			}
+			else if (!SlotFile.ReadLevelChunk(Entry.LevelName, ChunkData, Load.NameTable, Pool, &Load.PlacedTransforms.FindOrAdd(Entry.LevelName), &ChunkClassPaths))
+			{
+				continue;
+			}
 
-				Actor->Serialize(Ar);
-				LoadDataToComponent(Actor, ActorData.ComponentsSaveData);
+			LevelData = &Load.Levels.Add(Entry.LevelName, MoveTemp(ChunkData));
+			ClassPaths = &Load.LevelClassPaths.Add(Entry.LevelName, MoveTemp(ChunkClassPaths));
+		}
 
-				SpawnData.Remove(ActorData);
+		const int32 RecordIndex = LevelData->LevelActorData.IndexOfByPredicate([&](const FActorSaveData& Data)
+			{
+				return Data.ActorName == Entry.Record.ActorName;
+			});
 
-				if (Actor->Implements<USaveLoadActorInterface>())
-					ISaveLoadActorInterface::Execute_OnActorLoaded(Actor);
+		//Journaled records carry their whole transform
+		if (FSavePlacedTransforms* Placed = Load.PlacedTransforms.Find(Entry.LevelName))
+			Placed->UnresolvedParts.Remove(Entry.Record.ActorName);
 
-				IsDestroyed = false;
-				break;
+		//The class paths follow the records, AdoptPreparedLoad resolves them by record index
+		if (Entry.Op == ESaveJournalOp::ActorRemoved)
+		{
+			if (RecordIndex != INDEX_NONE)
+			{
+				LevelData->LevelActorData.RemoveAtSwap(RecordIndex);
+				ClassPaths->RemoveAtSwap(RecordIndex);
 			}
 		}
+		else if (RecordIndex != INDEX_NONE)
+		{
+			LevelData->LevelActorData[RecordIndex] = MoveTemp(Entry.Record);
+			(*ClassPaths)[RecordIndex] = Entry.ActorClassPath;
+		}
+		else
+		{
+			LevelData->LevelActorData.Add(MoveTemp(Entry.Record));
+			ClassPaths->Add(Entry.ActorClassPath);
+		}
 
-		if (IsDestroyed)
-			Actor->Destroy();
+		Load.JournalLevels.Add(Entry.LevelName);
 	}
+}
 
-	//Load data to all spawned actors in world
-	for (FActorSaveData ActorData : SpawnData)
+UMainSaveGame* USaveSubsystem::AdoptPreparedLoad(FPreparedLoad& Load)
+{
+	if (!Load.bSuccess)
+		return nullptr;
+
+	//The worker left every record class as its name table entry, they are loaded here on the game thread.
+	//From now on the save object and the subsystem's views keep them referenced
+	for (TPair<FName, FLevelSaveData>& Pair : Load.Levels)
 	{
-		AActor* Actor = World->SpawnActor<AActor>(ActorData.ActorClass, ActorData.Transform);
+		const TArray<int32>* ClassPaths = Load.LevelClassPaths.Find(Pair.Key);
+
+		for (int32 i = 0; ClassPaths != nullptr && i < ClassPaths->Num() && i < Pair.Value.LevelActorData.Num(); i++)
+		{
+			UObject* ActorClass = nullptr;
 
-		FMemoryReader Reader(ActorData.BinaryData);
+			if ((*ClassPaths)[i] != INDEX_NONE && Load.NameTable.GetObject((*ClassPaths)[i], ActorClass))
+				Pair.Value.LevelActorData[i].ActorClass = Cast<UClass>(ActorClass);
+		}
+	}
+
+	for (TPair<FName, FSaveLevelViewPtr>& Pair : Load.LevelViews)
+	{
+		Pair.Value->ResolveClasses(Load.NameTable);
+	}
 
-		FObjectAndNameAsStringProxyArchive Ar(Reader, true);
-		Ar.ArIsSaveGame = true;
+	UMainSaveGame* LoadedSaveGame = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
+	LoadedSaveGame->PlayerData = MoveTemp(Load.PlayerData);
+	LoadedSaveGame->WorldActorData = MoveTemp(Load.Levels);
+	LevelViews = MoveTemp(Load.LevelViews);
 
-		Actor->Serialize(Ar);
-		LoadDataToComponent(Actor, ActorData.ComponentsSaveData);
+	//Levels that streamed in since the load started may have added placed transforms, only the records' parts are taken over
+	for (TPair<FName, FSavePlacedTransforms>& Pair : Load.PlacedTransforms)
+	{
+		FSavePlacedTransforms& Placed = PlacedTransforms.FindOrAdd(Pair.Key);
+		Placed.UnresolvedParts = MoveTemp(Pair.Value.UnresolvedParts);
 
-		if (Actor->Implements<USaveLoadActorInterface>())
-			ISaveLoadActorInterface::Execute_OnActorLoaded(Actor);
+		if (Placed.Transforms.Num() == 0)
+			Placed.Transforms = MoveTemp(Pair.Value.Transforms);
 	}
 
-	OnLoadGame.Broadcast(SaveGameSlot);
+	NameTable.MoveFrom(Load.NameTable);
+
+	//Levels the journal changed are ahead of their chunks
+	DirtyLevelChunks = MoveTemp(Load.JournalLevels);
+	LoadedSlotName = Load.SlotName;
+
+	//Keeps appending to the journal that was replayed, or starts one for this snapshot
+	Journal = Load.Journal;
+
+	if (!bJournalSave)
+		Journal.Close();
+	else if (!Journal.IsOpen())
+		Journal.Start(Load.SlotName, Load.SlotInfo.Timestamp.GetTicks());
+
+	PlayTimeBase = Load.SlotInfo.PlayTimeSeconds;
+	PlayTimeStart = FPlatformTime::Seconds();
+
+	return LoadedSaveGame;
 }
 
-FName USaveSubsystem::GetLastSaveLevel(FString SlotName, bool& HasSave)
+UMainSaveGame* USaveSubsystem::LoadLegacySlot(const FString& SlotName)
 {
-	if (!UGameplayStatics::DoesSaveGameExist(SlotName, 0))
-	{
-		HasSave = false;
-		return FName();
-	}
+	return Cast<UMainSaveGame>(SaveSubsystemFile::LoadSaveGameFromSlot(SlotName, 0));
+}
 
-	SaveGameSlot = Cast<UMainSaveGame>(UGameplayStatics::CreateSaveGameObject(UMainSaveGame::StaticClass()));
-	HasSave = true;
+bool USaveSubsystem::DoesSlotExist(const FString& SlotName)
+{
+	return FSaveSlotFile::Exists(SlotName) || UGameplayStatics::DoesSaveGameExist(SlotName, 0);
+}
+
+UMainSaveGame* USaveSubsystem::ReadLegacySaveGame(const FString& SlotName)
+{
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_LoadReadSlot);
+
+	UMainSaveGame* LegacySaveGame = LoadLegacySlot(SlotName);
 
-	return SaveGameSlot->PlayerData.CurrentLevel;
+	if (LegacySaveGame == nullptr)
+		return nullptr;
+
+	//Legacy slots hold every level in one object, the next save converts all of them into chunks
+	TArray<FName> Levels;
+	LegacySaveGame->WorldActorData.GetKeys(Levels);
+
+	DirtyLevelChunks.Append(Levels);
+	LoadedSlotName.Empty();
+	NameTable.Reset();
+
+	PlayTimeBase = 0.0;
+	PlayTimeStart = FPlatformTime::Seconds();
+
+	return LegacySaveGame;
 }
 
 void USaveSubsystem::SavePlayer(UObject* WorldContext)
 {
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SavePlayer);
+
 	if (SaveGameSlot == nullptr)
 		return;
 
 	APlayableCharacter* PlayerCharacter = Cast<APlayableCharacter>(UGameplayStatics::GetPlayerCharacter(WorldContext, 0));
 	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(WorldContext, 0);
 
+	//Headless worlds such as the benchmark commandlet may run without a player
+	if (PlayerCharacter == nullptr || PlayerController == nullptr)
+		return;
+
 	FPlayerSavedata PlayerSaveData;
-	PlayerSaveData.CurrentLevel = WorldContext->GetFName();
+	PlayerSaveData.CurrentLevel = WorldContext->GetWorld()->GetFName();
 	PlayerSaveData.PlayerTransform = PlayerCharacter->GetActorTransform();
 	PlayerSaveData.ControlRotation = PlayerController->GetControlRotation();
 
-	FMemoryWriter CharacterWriter(PlayerSaveData.CharacterBinaryData);
-	FMemoryWriter ControllerWriter(PlayerSaveData.ControllerBinaryData);
-
-	FObjectAndNameAsStringProxyArchive CharacterAr(CharacterWriter, true);
-	FObjectAndNameAsStringProxyArchive ControllerAr(ControllerWriter, true);
-
-	ControllerAr.ArIsSaveGame = true;
-	CharacterAr.ArIsSaveGame = true;
-
 	PlayerSaveData.CharacterComponentsSaveData = SaveComponentData(PlayerCharacter);
 	PlayerSaveData.ControllerComponentsSaveData = SaveComponentData(PlayerController);
 
-	PlayerCharacter->Serialize(CharacterAr);
-	PlayerController->Serialize(ControllerAr);
+	FSaveNameTableArchive::SaveObject(PlayerCharacter, PlayerSaveData.CharacterBinaryData, NameTable);
+	FSaveNameTableArchive::SaveObject(PlayerController, PlayerSaveData.ControllerBinaryData, NameTable);
 
 	if (PlayerController->Implements<USaveLoadActorInterface>())
 	{
@@ -210,27 +2519,20 @@ void USaveSubsystem::SavePlayer(UObject* WorldContext)
 
 void USaveSubsystem::LoadPlayer(UObject* WorldContext)
 {
-	FPlayerSavedata Data = SaveGameSlot->PlayerData;
+	const FPlayerSavedata& Data = SaveGameSlot->PlayerData;
 
 	APlayableCharacter* PlayerCharacter = Cast<APlayableCharacter>(UGameplayStatics::GetPlayerCharacter(WorldContext, 0));
 	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(WorldContext, 0);
 
+	if (PlayerCharacter == nullptr || PlayerController == nullptr)
+		return;
+
 	PlayerController->SetControlRotation(Data.ControlRotation);
 	bool success = PlayerCharacter->SetActorLocation(Data.PlayerTransform.GetLocation(), false, nullptr, ETeleportType::ResetPhysics);
 
 
-	FMemoryReader CharacterReader(Data.CharacterBinaryData);
-	FMemoryReader ControllerReader(Data.ControllerBinaryData);
-
-	FObjectAndNameAsStringProxyArchive CharacterAr(CharacterReader, true);
-	FObjectAndNameAsStringProxyArchive ControllerAr(ControllerReader, true);
-
-	CharacterAr.ArIsSaveGame = true;
-	ControllerAr.ArIsSaveGame = true;
-
-
-	PlayerCharacter->Serialize(CharacterAr);
-	PlayerController->Serialize(ControllerAr);
+	FSaveNameTableArchive::LoadObject(PlayerCharacter, Data.CharacterBinaryData, NameTable);
+	FSaveNameTableArchive::LoadObject(PlayerController, Data.ControllerBinaryData, NameTable);
 
 	LoadDataToComponent(PlayerCharacter, Data.CharacterComponentsSaveData);
 	LoadDataToComponent(PlayerController, Data.ControllerComponentsSaveData);
@@ -247,50 +2549,346 @@ void USaveSubsystem::LoadPlayer(UObject* WorldContext)
 
 TArray<FActorComponentSaveData> USaveSubsystem::SaveComponentData(AActor* Actor)
 {
-	TArray<UActorComponent*> ActorComponents = Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass());
+	TArray<UActorComponent*> Components = Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass());
+	SaveComponentLayout::Sort(*SaveComponentLayout::Get(Actor, Components), Components);
+
 	TArray<FActorComponentSaveData> SaveComponents;
+	SaveComponentData(Components, SaveComponents);
+
+	return SaveComponents;
+}
+
+void USaveSubsystem::SaveComponentData(const TArray<UActorComponent*>& Components, TArray<FActorComponentSaveData>& OutData)
+{
+	//Written in place, a record that is saved again keeps its buffers
+	OutData.SetNum(Components.Num());
+
+	for (int32 i = 0; i < Components.Num(); i++)
+	{
+		FActorComponentSaveData& Data = OutData[i];
+		Data.ComponentName = Components[i]->GetFName();
+		Data.BinaryData.Reset();
+
+		FSaveNameTableArchive::SaveObject(Components[i], Data.BinaryData, NameTable);
+
+		ISaveLoadActorInterface::Execute_OnActorSave(Components[i]);
+	}
+}
+
+void USaveSubsystem::LoadDataToComponent(AActor* Actor, const TArray<FActorComponentSaveData>& Data)
+{
+	LoadDataToComponent(Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass()), Data);
+}
+
+void USaveSubsystem::LoadDataToComponent(const TArray<UActorComponent*>& Components, const TArray<FActorComponentSaveData>& Data)
+{
+	if (Components.Num() == 0 || Data.Num() == 0)
+		return;
 
-	for (UActorComponent* Component : ActorComponents)
+	const FSaveComponentLayoutRef Layout = SaveComponentLayout::Get(Components[0]->GetOwner(), Components);
+	TBitArray<> Applied(false, Data.Num());
+
+	for (UActorComponent* Component : Components)
 	{
-		FActorComponentSaveData Data;
-		Data.ComponentName = Component->GetFName();
+		const int32 Index = SaveComponentLayout::FindRecord(*Layout, MakeArrayView(Data), Applied, Component->GetFName());
 
-		FMemoryWriter Writer(Data.BinaryData);
-		FObjectAndNameAsStringProxyArchive Ar(Writer, true);
-		Ar.ArIsSaveGame = true;
+		if (Index == INDEX_NONE)
+			continue;
 
-		Component->Serialize(Ar);
-		SaveComponents.Add(Data);
+		FSaveNameTableArchive::LoadObject(Component, Data[Index].BinaryData, NameTable);
+		ISaveLoadActorInterface::Execute_OnActorLoaded(Component);
 
-		ISaveLoadActorInterface::Execute_OnActorSave(Component);
+		Applied[Index] = true;
 	}
+}
 
-	return SaveComponents;
+void USaveSubsystem::LoadDataToComponent(const TArray<UActorComponent*>& Components, TArrayView<const FSaveComponentView> Data)
+{
+	if (Components.Num() == 0 || Data.Num() == 0)
+		return;
+
+	const FSaveComponentLayoutRef Layout = SaveComponentLayout::Get(Components[0]->GetOwner(), Components);
+	TBitArray<> Applied(false, Data.Num());
+
+	for (UActorComponent* Component : Components)
+	{
+		const int32 Index = SaveComponentLayout::FindRecord(*Layout, Data, Applied, Component->GetFName());
+
+		if (Index == INDEX_NONE)
+			continue;
+
+		FSaveNameTableArchive::LoadObject(Component, Data[Index].BinaryData, NameTable);
+		ISaveLoadActorInterface::Execute_OnActorLoaded(Component);
+
+		Applied[Index] = true;
+	}
+}
+
+void USaveSubsystem::SaveActorData(AActor* Actor, const TArray<UActorComponent*>& Components, FActorSaveData& OutData)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveSerializeActor);
+	SAVE_TRACE_CLASS_SCOPE(Actor->GetClass());
+
+	if (Actor->Implements<USaveLoadActorInterface>())
+		ISaveLoadActorInterface::Execute_OnActorSave(Actor);
+
+	OutData.ActorClass = Actor->GetClass();
+	OutData.ActorName = Actor->GetFName();
+	OutData.Transform = Actor->GetActorTransform();
+	SaveComponentData(Components, OutData.ComponentsSaveData);
+
+	FSaveNameTableArchive::SaveObject(Actor, OutData.BinaryData, NameTable);
+}
+
+void USaveSubsystem::LoadActorData(AActor* Actor, const TArray<UActorComponent*>& Components, const FSaveLevelView& View, const FSaveActorView& Record, bool bApplyTransform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LoadApplyActor);
+	SAVE_TRACE_CLASS_SCOPE(Actor->GetClass());
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (bApplyTransform)
+		Actor->SetActorTransform(GetRecordTransform(Actor, Record));
+
+	FSaveNameTableArchive::LoadObject(Actor, Record.BinaryData, NameTable);
+	LoadDataToComponent(Components, View.GetComponents(Record));
+
+	if (Actor->Implements<USaveLoadActorInterface>())
+		ISaveLoadActorInterface::Execute_OnActorLoaded(Actor);
+
+	RecordLoadedActor(Actor->GetClass(), View, Record, FPlatformTime::Seconds() - StartTime);
+}
+
+bool USaveSubsystem::CanSerializeOffGameThread(AActor* Actor, const TArray<UActorComponent*>& Components) const
+{
+	const ISaveSerializationInterface* ActorSerialization = Cast<ISaveSerializationInterface>(Actor);
+
+	if (ActorSerialization == nullptr || !ActorSerialization->CanSerializeOffGameThread())
+		return false;
+
+	for (UActorComponent* Component : Components)
+	{
+		const ISaveSerializationInterface* ComponentSerialization = Cast<ISaveSerializationInterface>(Component);
+
+		if (ComponentSerialization == nullptr || !ComponentSerialization->CanSerializeOffGameThread())
+			return false;
+	}
+
+	return true;
+}
+
+void USaveSubsystem::BeginActorRecord(AActor* Actor, FActorSaveData& OutData)
+{
+	if (Actor->Implements<USaveLoadActorInterface>())
+		ISaveLoadActorInterface::Execute_OnActorSave(Actor);
+
+	OutData.ActorClass = Actor->GetClass();
+	OutData.ActorName = Actor->GetFName();
+	OutData.Transform = Actor->GetActorTransform();
 }
 
-void USaveSubsystem::LoadDataToComponent(AActor* Actor, TArray<FActorComponentSaveData> Data)
+void USaveSubsystem::SerializeActorsParallel(const TArray<FActorSerializeJob>& Jobs, TArray<FActorSaveData>& Records, FSaveNameTable& Table, int32 MaxWorkers, TArray<double>* OutJobSeconds)
 {
-	TArray<UActorComponent*> ActorComponents = Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass());
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_SaveSerializeParallel);
+
+	//Contiguous batches keep each worker on its own records, Records is never resized while the workers run
+	const int32 NumBatches = FMath::Clamp(MaxWorkers, 1, FMath::Max(Jobs.Num(), 1));
+	const int32 BatchSize = FMath::DivideAndRoundUp(Jobs.Num(), NumBatches);
 
-	for (UActorComponent* Component : ActorComponents)
+	if (OutJobSeconds != nullptr)
+		OutJobSeconds->SetNumZeroed(Jobs.Num());
+
+	ParallelFor(NumBatches, [&Jobs, &Records, &Table, BatchSize, OutJobSeconds](int32 Batch)
 	{
-		for (FActorComponentSaveData CompData : Data)
+		const int32 End = FMath::Min((Batch + 1) * BatchSize, Jobs.Num());
+
+		for (int32 i = Batch * BatchSize; i < End; i++)
 		{
-			if (CompData.ComponentName != Component->GetFName())
-				continue;
+			const double StartTime = FPlatformTime::Seconds();
 
-			FMemoryReader Reader(CompData.BinaryData);
-			FObjectAndNameAsStringProxyArchive Ar(Reader, true);
-			Ar.ArIsSaveGame = true;
+			const FActorSerializeJob& Job = Jobs[i];
+			FActorSaveData& Record = Records[Job.RecordIndex];
 
-			Component->Serialize(Ar);
-			ISaveLoadActorInterface::Execute_OnActorLoaded(Component);
+			SAVE_TRACE_CLASS_SCOPE(Job.Actor->GetClass());
 
-			break;
+			Record.ComponentsSaveData.SetNum(Job.Components.Num());
+
+			for (int32 c = 0; c < Job.Components.Num(); c++)
+			{
+				Record.ComponentsSaveData[c].ComponentName = Job.Components[c]->GetFName();
+				FSaveNameTableArchive::SaveObject(Job.Components[c], Record.ComponentsSaveData[c].BinaryData, Table);
+			}
+
+			FSaveNameTableArchive::SaveObject(Job.Actor, Record.BinaryData, Table);
+
+			if (OutJobSeconds != nullptr)
+				(*OutJobSeconds)[i] = FPlatformTime::Seconds() - StartTime;
+		}
+	}, NumBatches == 1);
+}
+
+void USaveSubsystem::BenchmarkParallelSerialize(TSubclassOf<AActor> ActorClass, int32 ActorCount)
+{
+	if (ActorClass == nullptr || ActorCount <= 0)
+		return;
+
+	//Never begins play and has no game instance, the actors stay out of gameplay, the registry and the save
+	UWorld* World = UWorld::CreateWorld(EWorldType::GamePreview, false, TEXT("SaveSerializeBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::GamePreview);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+
+	TArray<AActor*> Actors;
+	TArray<FActorSerializeJob> Jobs;
+
+	Actors.Reserve(ActorCount);
+	Jobs.Reserve(ActorCount);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 i = 0; i < ActorCount; i++)
+	{
+		const FVector Location((i % 100) * 200.0f, (i / 100) * 200.0f, 0.0f);
+		AActor* Actor = World->SpawnActor<AActor>(ActorClass, FTransform(Location), SpawnParams);
+
+		if (Actor == nullptr)
+			continue;
+
+		FActorSerializeJob& Job = Jobs.AddDefaulted_GetRef();
+		Job.Actor = Actor;
+		Job.Components = Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass());
+		Job.RecordIndex = Actors.Add(Actor);
+	}
+
+	const bool bThreadSafe = Jobs.Num() > 0 && CanSerializeOffGameThread(Jobs[0].Actor, Jobs[0].Components);
+
+	if (!bThreadSafe)
+		UE_LOG(LogTemp, Warning, TEXT("%s does not declare CanSerializeOffGameThread, timings are for comparison only"), *ActorClass->GetName());
+
+	//More batches than threads only queue up behind each other, each run gets as many threads as it has batches
+	const int32 MaxWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	const int32 RequestedWorkers[] = { 1, 4, 16 };
+
+	TArray<int32> WorkerCounts;
+
+	for (int32 Requested : RequestedWorkers)
+	{
+		if (Requested > MaxWorkers)
+			UE_LOG(LogTemp, Warning, TEXT("SaveSerialize run with %d workers capped at the %d threads available"), Requested, MaxWorkers);
+
+		WorkerCounts.AddUnique(FMath::Min(Requested, MaxWorkers));
+	}
+
+	double SingleWorkerSeconds = 0.0;
+
+	for (int32 Workers : WorkerCounts)
+	{
+		//Fresh table and records per run so every run pays for the same name table inserts
+		FSaveNameTable Table;
+		TArray<FActorSaveData> Records;
+		Records.SetNum(Jobs.Num());
+
+		const double StartTime = FPlatformTime::Seconds();
+		SerializeActorsParallel(Jobs, Records, Table, Workers);
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		if (Workers == 1)
+			SingleWorkerSeconds = Seconds;
+
+		int64 Bytes = 0;
+
+		for (const FActorSaveData& Record : Records)
+		{
+			Bytes += Record.BinaryData.Num();
+
+			for (const FActorComponentSaveData& ComponentRecord : Record.ComponentsSaveData)
+			{
+				Bytes += ComponentRecord.BinaryData.Num();
+			}
 		}
+
+		UE_LOG(LogTemp, Log, TEXT("SaveSerialize Actors=%d Workers=%d Cores=%d Time=%.3fms Speedup=%.2fx Bytes=%lld"),
+			Jobs.Num(), Workers, FPlatformMisc::NumberOfCoresIncludingHyperthreads(), Seconds * 1000.0,
+			Seconds > 0.0 ? SingleWorkerSeconds / Seconds : 0.0, Bytes);
+	}
+
+	World->DestroyWorld(false);
+	GEngine->DestroyWorldContext(World);
+}
+
+void USaveSubsystem::BuildActorRecordIndex(const FLevelSaveData& LevelData, TMap<FName, int32>& OutIndex)
+{
+	OutIndex.Reset();
+	OutIndex.Reserve(LevelData.LevelActorData.Num());
+
+	for (int32 i = 0; i < LevelData.LevelActorData.Num(); i++)
+	{
+		OutIndex.Add(LevelData.LevelActorData[i].ActorName, i);
 	}
 }
 
+void USaveSubsystem::RecordSavedActor(const UClass* Class, const FActorSaveData& Record, double Seconds)
+{
+	const int64 Bytes = SaveSubsystemReport::GetRecordBytes(Record);
+	const int32 Blobs = Record.ComponentsSaveData.Num() + 1;
+
+	FSaveClassCost& Cost = FindClassCost(LastSaveClassCosts, Class);
+	Cost.Actors++;
+	Cost.Blobs += Blobs;
+	Cost.Bytes += Bytes;
+	Cost.Seconds += Seconds;
+
+	INC_DWORD_STAT_BY(STAT_SaveBlobsWritten, Blobs);
+	INC_DWORD_STAT_BY(STAT_SaveBlobBytesWritten, Bytes);
+}
+
+void USaveSubsystem::RecordLoadedActor(const UClass* Class, const FSaveLevelView& View, const FSaveActorView& Record, double Seconds)
+{
+	FSaveClassCost& Cost = FindClassCost(LastLoadClassCosts, Class);
+	Cost.Actors++;
+	Cost.Blobs += Record.NumComponents + 1;
+	Cost.Bytes += View.GetRecordBytes(Record);
+	Cost.Seconds += Seconds;
+
+	INC_DWORD_STAT(STAT_LoadActorsApplied);
+}
+
+void USaveSubsystem::RecordDestroyedActor(const UClass* Class)
+{
+	FindClassCost(LastLoadClassCosts, Class).Destroyed++;
+
+	INC_DWORD_STAT(STAT_LoadActorsDestroyed);
+}
+
+FSaveClassCost& USaveSubsystem::FindClassCost(TMap<FObjectKey, FSaveClassCost>& Costs, const UClass* Class)
+{
+	FSaveClassCost& Cost = Costs.FindOrAdd(FObjectKey(Class));
+
+	//Kept by name, the class may be gone by the time the report is printed
+	if (Cost.ClassName.IsNone())
+		Cost.ClassName = Class->GetFName();
+
+	return Cost;
+}
+
+void USaveSubsystem::PrintCostReport(int32 MaxClasses) const
+{
+	const FSavePhaseTimings& Save = LastSaveTimings;
+	const FSavePhaseTimings& Load = LastLoadTimings;
+
+	UE_LOG(LogTemp, Display, TEXT("Last save: iterate %.3fms, serialize %.3fms, write %.3fms (compress %.3fms), %lld bytes written of %lld"),
+		Save.IterateSeconds * 1000.0, Save.SerializeSeconds * 1000.0, Save.WriteSeconds * 1000.0, Save.CompressSeconds * 1000.0, Save.BytesWritten, Save.BytesUncompressed);
+
+	SaveSubsystemReport::PrintClassCosts(TEXT("save"), LastSaveClassCosts, MaxClasses);
+
+	UE_LOG(LogTemp, Display, TEXT("Last load: read %.3fms (worker %.3fms), match %.3fms, spawn %.3fms"),
+		Load.ReadSeconds * 1000.0, Load.WorkerSeconds * 1000.0, Load.MatchSeconds * 1000.0, Load.SpawnSeconds * 1000.0);
+
+	SaveSubsystemReport::PrintClassCosts(TEXT("load"), LastLoadClassCosts, MaxClasses);
+}
+
 bool USaveSubsystem::IsActorAPlayer(AActor* Actor)
 {
 	return Cast<APlayerController>(Actor) || Cast<APlayableCharacter>(Actor);
@@ -298,17 +2896,24 @@ bool USaveSubsystem::IsActorAPlayer(AActor* Actor)
 
 void USaveSubsystem::InitiateOnActorLoadedCallback(UObject* WorldContext)
 {
-	for(FActorIterator It(WorldContext->GetWorld()); It; ++It)
-	{
-		AActor* Actor = *It;
+	SAVE_SCOPE_CYCLE_COUNTER(STAT_LoadLoadedCallbacks);
 
-		if(!Actor->ActorHasTag(FName("SaveObject")))
-			continue;
+	USaveObjectRegistry* Registry = WorldContext->GetWorld()->GetSubsystem<USaveObjectRegistry>();
+
+	if (Registry == nullptr)
+		return;
+
+	TArray<AActor*> SaveObjects;
+	TArray<UActorComponent*> Components;
 
+	Registry->GetSaveObjects(SaveObjects);
+
+	for (AActor* Actor : SaveObjects)
+	{
 		if (Actor->Implements<USaveLoadActorInterface>())
 			ISaveLoadActorInterface::Execute_OnActorLoaded(Actor);
 
-		TArray<UActorComponent*> Components = Actor->GetComponentsByInterface(USaveLoadActorInterface::StaticClass());
+		Registry->GetSaveComponents(Actor, Components);
 
 		for (UActorComponent* Comp : Components)
 		{
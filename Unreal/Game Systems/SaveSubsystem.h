@@ -4,13 +4,73 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/World.h"
+#include "Async/Future.h"
+#include "UObject/ObjectKey.h"
 #include "SaveDataType.h"
+#include "SaveNameTableArchive.h"
+#include "SaveSlotInfo.h"
+#include "SaveBlobPool.h"
+#include "SaveJournal.h"
+#include "SaveSlotFile.h"
+#include "SaveLevelView.h"
+#include "SaveSlotPrefetch.h"
 #include "SaveSubsystem.generated.h"
 
 class UMainSaveGame;
 
+//Wall time of each phase of the last save or load, read by the save benchmark commandlet
+struct FSavePhaseTimings
+{
+	double IterateSeconds = 0.0;
+	double SerializeSeconds = 0.0;
+	double WriteSeconds = 0.0;
+	double ReadSeconds = 0.0;
+
+	//Part of ReadSeconds spent on a worker by LoadGameAsync, everything else in a load runs on the game thread
+	double WorkerSeconds = 0.0;
+
+	double MatchSeconds = 0.0;
+	double SpawnSeconds = 0.0;
+
+	int64 BytesWritten = 0;
+
+	//Size of the written chunks before compression, BytesWritten covers them after it
+	int64 BytesUncompressed = 0;
+
+	//Wall time of compressing the chunks, part of WriteSeconds
+	double CompressSeconds = 0.0;
+
+	//Time every compression worker spent together, BytesUncompressed over it is the throughput of one core
+	double CompressWorkerSeconds = 0.0;
+};
+
+//What one actor class cost in the last save or load, printed by SaveSubsystem.Report
+struct FSaveClassCost
+{
+	FName ClassName;
+
+	//Actors of the class the save visited or the load applied a record to
+	int32 Actors = 0;
+
+	//Actor and component blobs serialized or loaded
+	int32 Blobs = 0;
+
+	int64 Bytes = 0;
+
+	//Game thread time, and worker time for actors serialized in parallel
+	double Seconds = 0.0;
+
+	int32 Spawned = 0;
+
+	//Placed actors the load destroyed because their record was gone
+	int32 Destroyed = 0;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSaveGame, UMainSaveGame*, SaveGameSlot);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSaveGameFinished, UMainSaveGame*, SaveGameSlot, bool, bSuccess);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLoadGame, UMainSaveGame*, SaveGameSlot);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSaveProgress, float, Progress);
 
 UCLASS()
 class SHADOWOFTHEOTHERSIDE_API USaveSubsystem : public UGameInstanceSubsystem
@@ -23,19 +83,111 @@ public:
 
 	virtual void Deinitialize() override;
 
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
 protected:
 
 	UPROPERTY()
 		UMainSaveGame* SaveGameSlot;
+
+	//Save object of the write in flight, handed to the save delegates once it finishes.
+	//The worker writes a copy of its records and never reads it
+	UPROPERTY()
+		UMainSaveGame* InFlightSaveGame;
 	
 public:
 
+	//Broadcast once a save was written, also when writing it failed
 	UPROPERTY(BlueprintAssignable, Category = "Save Subsystem")
 		FOnSaveGame OnSaveGame;
 
+	//Broadcast right after OnSaveGame with whether the slot made it to disk
+	UPROPERTY(BlueprintAssignable, Category = "Save Subsystem")
+		FOnSaveGameFinished OnSaveGameFinished;
+
 	UPROPERTY(BlueprintAssignable, Category = "Save Subsystem")
 		FOnLoadGame OnLoadGame;
 
+	//Broadcast every frame a time sliced save captures actors, Progress goes from 0 to 1
+	UPROPERTY(BlueprintAssignable, Category = "Save Subsystem")
+		FOnSaveProgress OnSaveProgress;
+
+	//Broadcast once LoadGame has restored everything, including actors respawned over later frames.
+	//Also fires when the slot holds nothing for the level
+	UPROPERTY(BlueprintAssignable, Category = "Save Subsystem")
+		FOnLoadGame OnGameFullyLoaded;
+
+	//Broadcast after OnSaveGame once a save started by SaveGameTimeSliced is on disk
+	UPROPERTY(BlueprintAssignable, Category = "Save Subsystem")
+		FOnSaveGameFinished OnTimeSlicedSaveComplete;
+
+	//Only reserialize SaveObject actors marked dirty since the last save, clean actors reuse their previous record
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem")
+		bool bIncrementalSave = false;
+
+	//Serialize actors declaring ISaveSerializationInterface::CanSerializeOffGameThread on worker threads.
+	//Off until the actors of a project are known to be safe, a wrong declaration races gameplay code
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem")
+		bool bParallelSerialize = false;
+
+	//Below this many thread safe actors the records are serialized on the game thread, dispatch costs more than it saves
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "1"))
+		int32 ParallelSerializeMinActors = 32;
+
+	//Upper bound on worker batches per save, 0 uses every task graph worker
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "0"))
+		int32 MaxSerializeWorkers = 0;
+
+	//Game thread time SaveGameTimeSliced may spend capturing actors per frame
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "0.1"))
+		float TimeSliceBudgetMs = 2.0f;
+
+	//Spread the actors LoadGame respawns over several frames, each frame spends at most RespawnBudgetMs
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem")
+		bool bTimeSlicedRespawn = true;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "0.1"))
+		float RespawnBudgetMs = 4.0f;
+
+	//Store actor and component blobs once in the profile's blob pool, level chunks of every slot reference them by hash
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem")
+		bool bPoolSaveBlobs = true;
+
+	//Codec every chunk of the slot is compressed with, each chunk stays readable on its own
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem")
+		ESaveChunkCodec SaveCodec = ESaveChunkCodec::LZ4;
+
+	//Compress the chunks of a save on worker threads in parallel instead of one after another on the save worker
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem")
+		bool bParallelCompression = true;
+
+	//Append every MarkSaveDirty change to a journal next to the current slot, loading the slot replays it.
+	//Frequent checkpoints then cost a small append instead of a chunk write
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem")
+		bool bJournalSave = false;
+
+	//Changes are collected and appended together at most this often
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "0"))
+		float JournalFlushInterval = 0.5f;
+
+	//Once the journal grows past this the changed chunks are written to the slot in the background and the journal starts over
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "1"))
+		int32 JournalCompactKB = 256;
+
+	//Every save also keeps a copy of the level and player records in memory, RestoreSnapshot goes back to one without touching the disk.
+	//The oldest snapshots are dropped once there are more than this, 0 disables them
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "0"))
+		int32 MaxSnapshots = 3;
+
+	//The oldest snapshots are dropped once all of them together hold more than this
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "1"))
+		int32 SnapshotMemoryCapKB = 32768;
+
+	//Memory PrefetchSlot may hold, bigger slots only get their header and table of contents read ahead.
+	//What the slot leaves goes to its journal and the pooled blobs of its level
+	UPROPERTY(BlueprintReadWrite, Category = "Save Subsystem", meta = (ClampMin = "0"))
+		int32 PrefetchMemoryCapKB = 65536;
+
 public:
 
 	UFUNCTION(BlueprintCallable, Category = "Save Subsystem", meta = (WorldContext = "WorldContext"))
@@ -44,19 +196,540 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Save Subsystem", meta = (WorldContext = "WorldContext"))
 		void LoadGame(UObject* WorldContext, const FString SlotName);
 
+	//Same as LoadGame, but the slot is read, decompressed, decoded and indexed on a worker while the loading screen is up.
+	//The game thread only applies the prepared records once they arrive, OnGameFullyLoaded fires when everything is in place
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem", meta = (WorldContext = "WorldContext"))
+		void LoadGameAsync(UObject* WorldContext, const FString SlotName);
+
+	//Loads SlotName into the next level this game instance opens, call it right before OpenLevel.
+	//Saved state and transforms are applied before any actor initializes, OnActorLoaded and the player follow after BeginPlay
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void LoadGameOnLevelLoad(const FString SlotName);
+
+	//Reads SlotName, its journal and the pooled blobs of its level into memory in the background, e.g. while the main menu is up,
+	//so the next LoadGame of it skips the disk.
+	//Replaces any prefetch already running. The memory is released once a load used it, or by CancelPrefetch
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void PrefetchSlot(const FString SlotName);
+
+	//Prefetches the newest slot on disk, the one a Continue button loads. Returns its name, empty when there is no slot
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		FString PrefetchLatestSlot();
+
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void CancelPrefetch();
+
+	//Memory held by a finished prefetch
+	int64 GetPrefetchBytes() const;
+
+	//Same as SaveGame but the actors are captured over several frames within TimeSliceBudgetMs, for autosaves during gameplay
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem", meta = (WorldContext = "WorldContext"))
+		void SaveGameTimeSliced(UObject* WorldContext, const FString SlotName);
+
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void MarkActorDirty(AActor* Actor);
+
+	//Marks the actor owning this actor, component or subobject as changed since the last save
+	static void MarkSaveDirty(UObject* Object);
+
+	//Called by the registry when a SaveObject is destroyed, the journal records the removal
+	static void MarkSaveDestroyed(AActor* Actor);
+
+	//Appends the queued journal changes now instead of waiting for JournalFlushInterval
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void FlushJournal();
+
+	//Puts the level back the way the snapshot of a previous save left it, Age 0 is the latest save.
+	//Works like LoadGame on the current world but skips reading and decoding the slot. Fails when the snapshot belongs to another level
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem", meta = (WorldContext = "WorldContext"))
+		bool RestoreSnapshot(UObject* WorldContext, int32 Age = 0);
+
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		void ClearSnapshots();
+
+	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
+		FORCEINLINE int32 GetSnapshotCount() const { return Snapshots.Num(); }
+
+	//Memory held by the snapshots, as estimated for SnapshotMemoryCapKB
+	FORCEINLINE int64 GetSnapshotBytes() const { return SnapshotBytes; }
+
+	static USaveSubsystem* Get(const UObject* WorldContext);
+
+	//Key of the records of Level in WorldActorData, the world's name for the persistent level and the package name for streamed sublevels
+	static FName GetLevelSaveName(const ULevel* Level);
+
+	//Reads a slot written before the chunked layout as the single save object it was written as, for tools inspecting or converting it
+	static UMainSaveGame* LoadLegacySlot(const FString& SlotName);
+
+	//Chunked slots are files of their own, legacy slots were written through the platform save system and are still looked up there
+	static bool DoesSlotExist(const FString& SlotName);
+
+	//Called by the registry when a sublevel streams out, captures only the SaveObject actors of that sublevel
+	void SaveStreamingLevel(ULevel* Level);
+
+	//Called by the registry when a sublevel streams in, applies its records and respawns its runtime actors
+	void LoadStreamingLevel(ULevel* Level);
+
+	//Names and object paths of the current slot, blobs written through FSaveNameTableArchive index into it
+	FORCEINLINE FSaveNameTable& GetNameTable() { return NameTable; }
+
+	//Blob pool the level chunks of every slot reference, tools point it at a file of their own before the first save
+	FORCEINLINE FSaveBlobPool& GetBlobPool() { return BlobPool; }
+
+	//Reads only the slot header, so it is cheap enough for menus
 	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
 		FName GetLastSaveLevel(FString SlotName, bool& HasSave);
 
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		bool GetSaveSlotInfo(FString SlotName, FSaveSlotInfo& OutInfo);
+
+	//Summaries of every slot on disk, newest first
+	UFUNCTION(BlueprintCallable, Category = "Save Subsystem")
+		TArray<FSaveSlotInfo> GetSaveSlots();
+
+	//Play time carried over from the loaded slot plus the time since it was loaded
+	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
+		float GetPlayTimeSeconds() const;
+
 	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
 		FORCEINLINE UMainSaveGame* GetSaveGameObject() { return SaveGameSlot;  }
 
+	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
+		FORCEINLINE bool IsSaveInProgress() { return bSaveInFlight || TimeSlicedSave.bActive; }
+
+	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
+		FORCEINLINE bool IsTimeSlicedSaveActive() { return TimeSlicedSave.bActive; }
+
+	//True while LoadGame is still respawning actors, OnGameFullyLoaded fires when it turns false
+	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
+		FORCEINLINE bool IsLoadInProgress() { return bLoadInFlight || PendingRespawns.bActive; }
+
+	//Fraction of the actors the running time sliced save has captured, 1 when none is running
+	UFUNCTION(BlueprintPure, Category = "Save Subsystem")
+		float GetSaveProgress() const;
+
+	//Blocks until the running save, including coalesced requests, is on disk
+	void WaitForPendingSave();
+
+	//Blocks until a LoadGameAsync has been applied and its actors respawned
+	void WaitForPendingLoad();
+
+	//Write time and bytes arrive once the write finished, respawn time once the respawn queue is empty
+	FORCEINLINE const FSavePhaseTimings& GetLastSaveTimings() const { return LastSaveTimings; }
+	FORCEINLINE const FSavePhaseTimings& GetLastLoadTimings() const { return LastLoadTimings; }
+
+	//Per actor class, reset by every save and every load
+	FORCEINLINE const TMap<FObjectKey, FSaveClassCost>& GetLastSaveClassCosts() const { return LastSaveClassCosts; }
+	FORCEINLINE const TMap<FObjectKey, FSaveClassCost>& GetLastLoadClassCosts() const { return LastLoadClassCosts; }
+
+	//Logs the phase timings of the last save and load and their most expensive classes, MaxClasses 0 logs every class
+	void PrintCostReport(int32 MaxClasses = 0) const;
+
+	//Spawns ActorCount actors of ActorClass into a throwaway world and logs how serializing them scales over 1, 4 and 16 workers,
+	//capped at the threads the task graph has
+	void BenchmarkParallelSerialize(TSubclassOf<AActor> ActorClass, int32 ActorCount);
+
 private:
 
+	//Actor whose record is serialized off the game thread, OnActorSave and the record header are done up front
+	struct FActorSerializeJob
+	{
+		AActor* Actor = nullptr;
+
+		TArray<UActorComponent*> Components;
+
+		int32 RecordIndex = INDEX_NONE;
+	};
+
+	//Everything a time sliced save carries between frames. The actor list, transforms and dirty set are cut in the first frame
+	struct FTimeSlicedSave
+	{
+		bool bActive = false;
+
+		FString SlotName;
+
+		TWeakObjectPtr<UWorld> World;
+
+		FName LevelName;
+
+		TArray<TWeakObjectPtr<AActor>> Actors;
+
+		TArray<FTransform> Transforms;
+
+		TSet<TObjectKey<AActor>> FrozenDirtyActors;
+
+		//Previous records of the level, taken out of SaveGameSlot so clean actors can move theirs over
+		FLevelSaveData PreviousLevelData;
+
+		TMap<FName, int32> PreviousIndex;
+
+		TArray<FActorSaveData> ActorSave;
+
+		int32 NextActor = 0;
+	};
+
+	//Actor waiting for its next journal entry, the names are kept for when it is gone by then
+	struct FJournalTarget
+	{
+		TWeakObjectPtr<AActor> Actor;
+
+		FName LevelName;
+
+		FName ActorName;
+
+		bool bPlayer = false;
+
+		bool bDestroyed = false;
+	};
+
+	//Copy of what one save captured, kept so RestoreSnapshot does not have to read the slot back
+	struct FSaveSnapshot
+	{
+		FString SlotName;
+
+		//Timestamp the save wrote the slot with
+		int64 SlotTicks = 0;
+
+		//Persistent level of the world the save was made in
+		FName LevelName;
+
+		//Records of the persistent level and the sublevels that were loaded, keyed like WorldActorData
+		TMap<FName, FLevelSaveData> Levels;
+
+		FPlayerSavedata PlayerData;
+
+		int64 Bytes = 0;
+	};
+
+	//Everything a load reads and decodes before it touches the world.
+	//PrepareLoad only touches this and the blob pool, so LoadGameAsync runs it on a worker
+	struct FPreparedLoad
+	{
+		FString SlotName;
+
+		//Persistent level of the world being loaded
+		FName LevelName;
+
+		//Chunks read up front, the persistent level and every sublevel already loaded
+		TArray<FName> LevelNames;
+
+		bool bIndexRecords = false;
+
+		//False for slots from before the chunked layout, they are read on the game thread
+		bool bChunked = false;
+
+		bool bSuccess = false;
+
+		FSaveNameTable NameTable;
+
+		FSaveSlotInfo SlotInfo;
+
+		FPlayerSavedata PlayerData;
+
+		//Levels the journal changed, decoded into records so the journal can be applied
+		TMap<FName, FLevelSaveData> Levels;
+
+		//Name table entry of the class of every record in Levels in record order.
+		//The worker loads no objects, the record classes stay null until AdoptPreparedLoad resolves them
+		TMap<FName, TArray<int32>> LevelClassPaths;
+
+		//Every other level that was read, decoded in place with deferred classes. The view of LevelName is indexed when bIndexRecords is set
+		TMap<FName, FSaveLevelViewPtr> LevelViews;
+
+		//Levels the journal changed, their chunks are out of date
+		TSet<FName> JournalLevels;
+
+		//Copied from the subsystem on the game thread, the records read are resolved against it
+		TMap<FName, FSavePlacedTransforms> PlacedTransforms;
+
+		FSaveJournal Journal;
+
+		//Prefetch of SlotName, the slot, journal and pool are each read out of its memory when it finished and the file wasn't written since.
+		//Dropped once the slot is read
+		FSaveSlotPrefetchPtr Prefetch;
+
+		double ReadSeconds = 0.0;
+	};
+
+	//Records of actors spawned at runtime that LoadGame still has to respawn
+	struct FPendingRespawns
+	{
+		bool bActive = false;
+
+		TWeakObjectPtr<UWorld> World;
+
+		//Records of the persistent level, the journal holds back changes to them until the queue is empty
+		FSaveLevelViewPtr View;
+
+		TArray<int32> Records;
+
+		int32 NextRecord = 0;
+	};
+
+private:
+
+	bool bSaveInFlight = false;
+
+	//The write in flight was started by a time sliced save
+	bool bTimeSlicedWriteInFlight = false;
+
+	//The coalesced request came from SaveGameTimeSliced
+	bool bPendingTimeSliced = false;
+
+	FTimeSlicedSave TimeSlicedSave;
+
+	FDelegateHandle TimeSlicedTickHandle;
+
+	FPendingRespawns PendingRespawns;
+
+	//Slot LoadGameOnLevelLoad applies to the next world this game instance initializes
+	FString LevelLoadSlotName;
+
+	//World whose saved state was applied before BeginPlay and that still waits for its OnActorLoaded callbacks
+	TWeakObjectPtr<UWorld> LevelLoadWorld;
+
+	FDelegateHandle LevelLoadTickHandle;
+
+	//The level load slot held records for its world, the player is restored along with the callbacks
+	bool bLevelLoadHasRecords = false;
+
+	FDelegateHandle PostWorldInitHandle;
+
+	FDelegateHandle RespawnTickHandle;
+
+	//Set when SaveGame is called while a write is in flight, only the latest request is kept
+	bool bSavePending = false;
+
+	FString PendingSaveSlotName;
+
+	TWeakObjectPtr<UObject> PendingSaveWorldContext;
+
+	TFuture<void> SaveTask;
+
+	bool bLoadInFlight = false;
+
+	//Bumped by every load, a prepared load that arrives for an older one is dropped
+	int32 LoadRequestId = 0;
+
+	TFuture<void> LoadTask;
+
+	FSaveSlotPrefetchPtr Prefetch;
+
+	TSet<TObjectKey<AActor>> DirtyActors;
+
+	//Levels captured in SaveGameSlot whose chunk on disk is out of date
+	TSet<FName> DirtyLevelChunks;
+
+	//Chunked slot the unloaded levels live in, empty when there is none yet
+	FString LoadedSlotName;
+
+	//Bumped whenever a load or new game replaces the session, a write finishing for an older one leaves the new session alone
+	int32 SessionId = 0;
+
+	//Sublevels that streamed out while a write was in flight, merged into SaveGameSlot once it is done
+	TMap<FName, FLevelSaveData> StreamedLevelRecords;
+
+	//Sublevels that streamed in while a write was in flight with their records only in the slot being written, applied once it is done
+	TArray<TWeakObjectPtr<ULevel>> DeferredStreamingLevels;
+
+	//Levels of the loaded slot whose records nothing changed yet, read straight from their chunk.
+	//A level moves into SaveGameSlot once its records are about to change
+	TMap<FName, FSaveLevelViewPtr> LevelViews;
+
+	//Placed transforms of every level loaded so far by level save name, they don't change with the session.
+	//The unresolved parts belong to the records of the session and are dropped with it
+	TMap<FName, FSavePlacedTransforms> PlacedTransforms;
+
+	FSaveNameTable NameTable;
+
+	//Shared by every slot, only touched by the save task while a write is in flight
+	FSaveBlobPool BlobPool;
+
+	FSaveJournal Journal;
+
+	//Actors changed since the last journal flush
+	TMap<TObjectKey<AActor>, FJournalTarget> JournalQueue;
+
+	FDelegateHandle JournalTickHandle;
+
+	//Batches are appended one at a time in the order they were encoded
+	TFuture<void> JournalTask;
+
+	//Oldest first
+	TArray<FSaveSnapshot> Snapshots;
+
+	int64 SnapshotBytes = 0;
+
+	//Timestamp of the last slot write that was started
+	int64 LastWriteTicks = 0;
+
+	FSavePhaseTimings LastSaveTimings;
+
+	double PlayTimeBase = 0.0;
+
+	double PlayTimeStart = 0.0;
+
+	FSavePhaseTimings LastLoadTimings;
+
+	TMap<FObjectKey, FSaveClassCost> LastSaveClassCosts;
+
+	TMap<FObjectKey, FSaveClassCost> LastLoadClassCosts;
+
+private:
+
+	//Serializes, compresses and writes the changed chunks of SaveGameSlot on a worker thread
+	void WriteSaveGameAsync(const FString& SlotName);
+
+	void OnSaveWriteFinished(bool bSuccess, const FString& SlotName, const TArray<FName>& Levels, int32 WriteSessionId);
+
+	bool TickTimeSlicedSave(float DeltaTime);
+
+	void FinishTimeSlicedSave();
+
+	//Drops the running time sliced save, the level keeps its previous records and the frozen dirty flags are restored
+	void CancelTimeSlicedSave();
+
+	void OnPostWorldInitialization(UWorld* World, const UWorld::InitializationValues IVS);
+
+	bool TickLevelLoad(float DeltaTime);
+
+	//Runs once the level load world has begun play
+	void FinishLevelLoad(UWorld* World);
+
+	void QueueJournal(AActor* Actor, bool bDestroyed);
+
+	bool TickJournal(float DeltaTime);
+
+	void WaitForJournal();
+
+	//Drops the queued changes, nothing is journaled until a slot is loaded or written again
+	void CloseJournal();
+
+	//Applies the journal of the snapshot in SlotFile to Load, Load.Journal keeps appending to it afterwards
+	static void ReplayJournal(FPreparedLoad& Load, const FSaveSlotFile& SlotFile, const FSaveBlobPool* Pool);
+
+	//Reads and decodes the chunks of Load.LevelNames and replays the journal, safe to run on a worker
+	static void PrepareLoad(FPreparedLoad& Load, FSaveBlobPool* Pool);
+
+	//Moves a prepared load into a new save object, the name table and the journal, game thread only
+	UMainSaveGame* AdoptPreparedLoad(FPreparedLoad& Load);
+
+	UMainSaveGame* ReadLegacySaveGame(const FString& SlotName);
+
+	void FinishLoadAsync(FPreparedLoad& Load, UObject* WorldContext, int32 RequestId);
+
+	//Stops everything a previous load or save left running, a new load replaces its results
+	void CancelPendingLoads();
+
+	//Hands the prefetch of SlotName to a load, a prefetch of any other slot is cancelled since the menu it was for is gone
+	FSaveSlotPrefetchPtr TakePrefetch(const FString& SlotName);
+
+	//Closes the journal and drops the snapshots, parked sublevels and slot bookkeeping of the session being replaced
+	void ResetLoadedSession();
+
+	//Replaces the session with an empty save object, for a slot that doesn't exist or failed to read.
+	//bNotify false leaves OnActorLoaded and OnGameFullyLoaded to the caller, for loads that fire them once play has begun
+	void StartNewSession(UObject* WorldContext, bool bNotify = true);
+
+	static void GetLoadedLevelNames(UWorld* World, TArray<FName>& OutLevelNames);
+
+	//Takes the placed transforms of Level from the registry and fills in the records read before they were known
+	void UpdatePlacedTransforms(ULevel* Level);
+
+	//Same as above for every level loaded in World
+	void UpdatePlacedTransforms(UWorld* World);
+
+	//Transform a record puts its actor at, the parts left at the placed transform come from the live actor's registry entry
+	static FTransform GetRecordTransform(AActor* Actor, const FSaveActorView& Record);
+
+	//Copies the records the save just captured for World into the snapshot ring and evicts the oldest ones over the limits
+	void PushSnapshot(const FString& SlotName, UWorld* World);
+
+	//Matches the records of SaveGameSlot for the world against its actors and respawns the rest, shared by LoadGame and RestoreSnapshot
+	void ApplyLoadedLevel(UObject* WorldContext);
+
+	//Respawns the queued records now or from the ticker, depending on bTimeSlicedRespawn
+	void StartRespawns();
+
+	//Respawns records until the budget runs out, a budget of 0 respawns everything left
+	bool ProcessRespawns(double BudgetSeconds);
+
+	bool TickRespawns(float DeltaTime);
+
+	//Respawns everything still queued right away, the world has to be complete before it is saved
+	void FlushRespawns();
+
+	void CancelRespawns();
+
+	//Spawns the actor deferred so its saved state is in place before construction finishes and BeginPlay runs.
+	//Level is the streamed sublevel the record belongs to, null spawns it into the persistent level
+	AActor* RespawnActor(UWorld* World, const FSaveLevelView& View, const FSaveActorView& Record, ULevel* Level = nullptr);
+
+	//Serializes the SaveObject actors of one level and replaces its record set, clean actors reuse their record in incremental mode
+	void CaptureLevel(ULevel* Level, const TArray<AActor*>& Actors);
+
+	//Replaces the record set of LevelName, parked until the write in flight is done
+	void StoreLevelRecords(FName LevelName, FLevelSaveData&& LevelData);
+
+	//Records of LevelName in memory for code that changes them, copied out of the level's view or read from the loaded slot's chunk.
+	//Without bReadChunk, or while a write is in flight, only levels already in memory are returned
+	FLevelSaveData* FindLevelRecords(FName LevelName, bool bReadChunk = true);
+
+	//Read only records of LevelName for loading, records in memory are viewed in place and a chunk is decoded without copying its blobs.
+	//Views over records in memory are only valid until those records change. Null for a level only on disk while a write is in flight
+	FSaveLevelViewPtr GetLevelView(FName LevelName, bool bReadChunk = true);
+
+	//Registered actors of World by level, every level in the world gets an entry even without actors
+	void GatherLevelActors(UWorld* World, TMap<ULevel*, TArray<AActor*>>& OutLevelActors);
+
+	//Matches the records of a streamed sublevel against its actors, OutRespawns gets the records no actor claimed.
+	//Without callbacks OnActorLoaded is left to InitiateOnActorLoadedCallback
+	bool ApplyStreamingLevel(ULevel* Level, bool bLoadedCallbacks, TArray<int32>& OutRespawns);
+
+	void RespawnStreamingLevel(ULevel* Level, const TArray<int32>& Records);
+
+	//Same as above for every sublevel loaded in World
+	void ApplyStreamingLevels(UWorld* World, bool bLoadedCallbacks, TArray<TPair<ULevel*, TArray<int32>>>& OutRespawns);
+	void RespawnStreamingLevels(const TArray<TPair<ULevel*, TArray<int32>>>& Respawns);
+
+	//Loads every record in Data whose bit in Applied is still clear into the component with the same name, found through the class's component layout
+	void ApplyComponentData(const TArray<UActorComponent*>& Components, TArrayView<const FSaveComponentView> Data, TBitArray<>& Applied, TArray<UActorComponent*>& OutLoaded);
+
+	//Reads the player chunk and the chunks of the levels loaded in World only, legacy slots are read in full
+	UMainSaveGame* ReadSaveGameForLevel(const FString& SlotName, UWorld* World);
+
 	void SavePlayer(UObject* WorldContext);
 	void LoadPlayer(UObject* WorldContext);
 
 	TArray<FActorComponentSaveData> SaveComponentData(AActor* Actor);
-	void LoadDataToComponent(AActor* Actor, TArray<FActorComponentSaveData> Data);
+	void LoadDataToComponent(AActor* Actor, const TArray<FActorComponentSaveData>& Data);
+
+	//Same as above with the save components already looked up in layout order, registered actors use the registry's cache
+	void SaveComponentData(const TArray<UActorComponent*>& Components, TArray<FActorComponentSaveData>& OutData);
+	void LoadDataToComponent(const TArray<UActorComponent*>& Components, const TArray<FActorComponentSaveData>& Data);
+	void LoadDataToComponent(const TArray<UActorComponent*>& Components, TArrayView<const FSaveComponentView> Data);
+
+	void SaveActorData(AActor* Actor, const TArray<UActorComponent*>& Components, FActorSaveData& OutData);
+	void LoadActorData(AActor* Actor, const TArray<UActorComponent*>& Components, const FSaveLevelView& View, const FSaveActorView& Record, bool bApplyTransform);
+
+	bool CanSerializeOffGameThread(AActor* Actor, const TArray<UActorComponent*>& Components) const;
+
+	//Runs OnActorSave and fills everything but the blobs, game thread only
+	void BeginActorRecord(AActor* Actor, FActorSaveData& OutData);
+
+	//Writes the actor and component blobs of every job into Records, split into at most MaxWorkers batches.
+	//OutJobSeconds gets the time spent on each job when given
+	static void SerializeActorsParallel(const TArray<FActorSerializeJob>& Jobs, TArray<FActorSaveData>& Records, FSaveNameTable& Table, int32 MaxWorkers, TArray<double>* OutJobSeconds = nullptr);
+
+	//Adds one actor's record to the cost of its class and to the stat counters
+	void RecordSavedActor(const UClass* Class, const FActorSaveData& Record, double Seconds);
+	void RecordLoadedActor(const UClass* Class, const FSaveLevelView& View, const FSaveActorView& Record, double Seconds);
+	void RecordDestroyedActor(const UClass* Class);
+
+	static FSaveClassCost& FindClassCost(TMap<FObjectKey, FSaveClassCost>& Costs, const UClass* Class);
+
+	//Maps every saved actor name to its index in LevelActorData
+	static void BuildActorRecordIndex(const FLevelSaveData& LevelData, TMap<FName, int32>& OutIndex);
 
 	bool IsActorAPlayer(AActor* Actor);
 
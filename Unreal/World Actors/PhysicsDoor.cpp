@@ -12,6 +12,7 @@
 #include "Components/AudioComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundBase.h"
+#include "SaveSubsystem.h"
 
 // Sets default values
 APhysicsDoor::APhysicsDoor()
@@ -106,6 +107,8 @@ void APhysicsDoor::SetDoorState(EDoorState State, FVector SwingDirection)
 	DoorState = State;
 	Door1Constraint->SetAngularOrientationTarget(AngularTarget);
 
+	USaveSubsystem::MarkSaveDirty(this);
+
 	if(Door1Mesh->IsSimulatingPhysics())
 		Door1Mesh->AddAngularImpulseInDegrees(FVector::ZeroVector);
 
@@ -362,3 +365,19 @@ void APhysicsDoor::OnActorLoaded_Implementation()
 		InitializeDoor(DoorState);
 	}
 }
+
+void APhysicsDoor::SerializeNative(FArchive& Ar, int32 Version)
+{
+	uint8 ContainsSaveData = bContainsSaveData ? 1 : 0;
+	uint8 State = (uint8)DoorState;
+
+	Ar << ContainsSaveData;
+	Ar << ConvertedDoorState;
+	Ar << State;
+
+	if (Ar.IsLoading())
+	{
+		bContainsSaveData = ContainsSaveData != 0;
+		DoorState = (EDoorState)State;
+	}
+}
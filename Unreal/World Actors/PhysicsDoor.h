@@ -8,6 +8,7 @@
 #include "InteractableInterface.h"
 #include "ItemUseInterface.h"
 #include "SaveLoadActorInterface.h"
+#include "SaveSerializationInterface.h"
 #include "PhysicsDoor.generated.h"
 
 class UPhysicsConstraintComponent;
@@ -22,7 +23,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDoorSignature);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDoorStateSignature, EDoorState, State);
 
 UCLASS()
-class SHADOWOFTHEOTHERSIDE_API APhysicsDoor : public AActor,public IInteractableInterface, public IItemUseInterface, public ISaveLoadActorInterface
+class SHADOWOFTHEOTHERSIDE_API APhysicsDoor : public AActor,public IInteractableInterface, public IItemUseInterface, public ISaveLoadActorInterface, public ISaveSerializationInterface
 {
 	GENERATED_BODY()
 	
@@ -203,4 +204,12 @@ public:
 
 		virtual void OnActorSave_Implementation() override;
 		virtual void OnActorLoaded_Implementation() override;
+
+		//Door state is plain SaveGame values, nothing is touched while serializing
+		virtual bool CanSerializeOffGameThread() const override { return true; }
+
+		//Doors are the most common save object in a level, their three values are written as a fixed layout
+		virtual int32 GetNativeSaveVersion() const override { return 1; }
+		virtual const UClass* GetNativeSaveClass() const override { return APhysicsDoor::StaticClass(); }
+		virtual void SerializeNative(FArchive& Ar, int32 Version) override;
 };	